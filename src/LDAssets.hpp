@@ -7,6 +7,9 @@
 
 #include "LDDependencies.hpp"
 #include "LDConfig.hpp"
+#include "LDAtlas.hpp"
+#include "LDAudio.hpp"
+#include "LDSoundPool.hpp"
 
 namespace ld
 {
@@ -14,10 +17,12 @@ namespace ld
     {
     private:
         ssvs::AssetManager<> assetManager;
+        ssvu::UPtr<LDAudio> audio; // Null when headless
+        sf::FloatRect soundCullRect;
+        bool soundCulling{false};
 
     public:
-        ssvs::SoundPlayer soundPlayer;
-        ssvs::MusicPlayer musicPlayer;
+        LDAtlas atlas;
         ssvs::Tileset tilesetChar{
             ssvj::fromFile("Data/Tilesets/tilesetChar.json")
                 .as<ssvs::Tileset>()};
@@ -25,13 +30,35 @@ namespace ld
             ssvj::fromFile("Data/Tilesets/tilesetWorld.json")
                 .as<ssvs::Tileset>()};
 
-        inline LDAssets()
+        // Headless assets (tests and benchmarks) never reach the screen or
+        // the speakers: there is no audio, textures are only decoded for
+        // the atlas layout and the font refers to the empty atlas texture
+        inline LDAssets(bool mHeadless = false)
         {
+            const std::vector<std::string> atlasIds{
+                "worldTiles.png", "charTiles.png", "limeStroked.png"};
+
+            if(mHeadless)
+            {
+                std::vector<sf::Image> images(atlasIds.size());
+                for(auto i(0u); i < atlasIds.size(); ++i)
+                    images[i].loadFromFile("Data/" + atlasIds[i]);
+                atlas.pack(atlasIds, images, false);
+
+                assetManager.load<ssvs::BitmapFont>("limeStroked",
+                    atlas.getTexture(), ssvj::fromFile("Data/lime.json")
+                                            .as<ssvs::BitmapFontData>());
+                return;
+            }
+
             ssvs::loadAssetsFromJson(
                 assetManager, "Data/", ssvj::fromFile("Data/assets.json"));
+            atlas.build(assetManager, atlasIds);
 
-            soundPlayer.setVolume(50);
-            musicPlayer.setVolume(30);
+            audio = ssvu::mkUPtr<LDAudio>();
+            audio->start(assetManager);
+            audio->setSoundVolume(50);
+            audio->setMusicVolume(30);
         }
 
         inline auto& operator()() { return assetManager; }
@@ -41,18 +68,56 @@ namespace ld
             return assetManager.get<T>(mId);
         }
 
-        inline void playSound(const std::string& mName,
-            ssvs::SoundPlayer::Mode mMode = ssvs::SoundPlayer::Mode::Overlap,
+        inline void playSound(LDSound mSound,
+            LDSoundPool::Mode mMode = LDSoundPool::Mode::Overlap,
+            float mPitch = 1.f)
+        {
+            if(audio == nullptr || !LDConfig::get().soundEnabled) return;
+            audio->playSound(mSound, mMode, mPitch);
+        }
+        inline void playSoundAt(LDSound mSound, const ssvs::Vec2i& mPos,
+            LDSoundPool::Mode mMode = LDSoundPool::Mode::Overlap,
             float mPitch = 1.f)
         {
-            if(!LDConfig::get().soundEnabled) return;
-            soundPlayer.play(get<sf::SoundBuffer>(mName), mMode, mPitch);
+            if(isAudible(mPos)) playSound(mSound, mMode, mPitch);
         }
         inline void playMusic(const std::string& mName)
         {
-            if(!LDConfig::get().musicEnabled) return;
-            musicPlayer.play(get<sf::Music>(mName));
-            musicPlayer.setLoop(true);
+            if(audio == nullptr || !LDConfig::get().musicEnabled) return;
+            audio->playMusic(get<sf::Music>(mName));
+        }
+        inline void stopMusic()
+        {
+            if(audio != nullptr) audio->stopMusic();
+        }
+
+        // Sounds positioned outside `mRect` (in world coordinates) are
+        // culled
+        inline void setSoundCullRect(const sf::FloatRect& mRect) noexcept
+        {
+            soundCullRect = mRect;
+            soundCulling = true;
+        }
+        inline bool isAudible(const ssvs::Vec2i& mPos) const
+        {
+            return !soundCulling || soundCullRect.contains(ssvs::Vec2f(mPos));
+        }
+
+        inline void setSoundVolume(float mVolume)
+        {
+            if(audio != nullptr) audio->setSoundVolume(mVolume);
+        }
+        inline void setMusicVolume(float mVolume)
+        {
+            if(audio != nullptr) audio->setMusicVolume(mVolume);
+        }
+        inline float getSoundVolume() const
+        {
+            return audio == nullptr ? 0.f : audio->getSoundVolume();
+        }
+        inline float getMusicVolume() const
+        {
+            return audio == nullptr ? 0.f : audio->getMusicVolume();
         }
     };
 }
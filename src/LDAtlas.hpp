@@ -0,0 +1,89 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_ATLAS
+#define SSVLD_ATLAS
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    // Packs loaded textures into a single texture at load time, so that
+    // world, character and label drawing never switch textures.
+    // Textures are stacked in rows; every source keeps its own layout, so
+    // tileset and glyph rects only need to be offset.
+    class LDAtlas
+    {
+    private:
+        static constexpr unsigned int padding{2};
+
+        sf::Texture texture;
+        std::unordered_map<std::string, ssvs::Vec2i> offsets;
+
+    public:
+        inline static sf::IntRect getOffsetRect(
+            sf::IntRect mRect, const ssvs::Vec2i& mOffset) noexcept
+        {
+            mRect.left += mOffset.x;
+            mRect.top += mOffset.y;
+            return mRect;
+        }
+
+        // Packs `mImages`, named by `mIds`. Headless runs only need the
+        // layout: without `mUpload` the texture stays empty
+        inline void pack(const std::vector<std::string>& mIds,
+            const std::vector<sf::Image>& mImages, bool mUpload = true)
+        {
+            unsigned int width{0}, height{0};
+            for(const auto& i : mImages)
+            {
+                width = std::max(width, i.getSize().x);
+                height += i.getSize().y + padding;
+            }
+
+            sf::Image atlas;
+            atlas.create(width, height, sf::Color::Transparent);
+
+            unsigned int y{0};
+            for(auto i(0u); i < mImages.size(); ++i)
+            {
+                atlas.copy(mImages[i], 0, y);
+                offsets[mIds[i]] = {0, ssvu::toInt(y)};
+                y += mImages[i].getSize().y + padding;
+            }
+
+            if(mUpload) texture.loadFromImage(atlas);
+        }
+
+        template <typename TAssetManager>
+        inline void build(TAssetManager& mAssetManager,
+            const std::vector<std::string>& mTextureIds)
+        {
+            std::vector<sf::Image> images;
+            images.reserve(mTextureIds.size());
+            for(const auto& id : mTextureIds)
+                images.emplace_back(
+                    mAssetManager.template get<sf::Texture>(id)
+                        .copyToImage());
+
+            pack(mTextureIds, images);
+        }
+
+        inline const sf::Texture& getTexture() const noexcept
+        {
+            return texture;
+        }
+        inline const ssvs::Vec2i& getOffset(const std::string& mId) const
+        {
+            return offsets.at(mId);
+        }
+        inline sf::IntRect operator()(
+            const std::string& mId, const sf::IntRect& mRect) const
+        {
+            return getOffsetRect(mRect, getOffset(mId));
+        }
+    };
+}
+
+#endif
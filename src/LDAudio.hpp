@@ -0,0 +1,154 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_AUDIO
+#define SSVLD_AUDIO
+
+#include <atomic>
+#include <thread>
+
+#include "LDDependencies.hpp"
+#include "LDSoundPool.hpp"
+#include "LDSPSCQueue.hpp"
+#include "LDWakeSignal.hpp"
+
+namespace ld
+{
+    struct LDAudioCommand
+    {
+        enum class Type
+        {
+            PlaySound,
+            PlayMusic,
+            StopMusic,
+            SetSoundVolume,
+            SetMusicVolume
+        };
+
+        Type type;
+        LDSound sound;
+        LDSoundPool::Mode mode;
+        float value; // Pitch or volume
+        sf::Music* music;
+    };
+
+    // Owns the sound pool and the music player on a dedicated thread.
+    // The simulation thread only pushes commands into a lock-free queue:
+    // it never waits on the audio backend. If the queue is full, the
+    // command is dropped. With no commands queued, the thread sleeps.
+    class LDAudio
+    {
+    private:
+        static constexpr std::size_t queueSize{256};
+
+        LDSoundPool soundPool;
+        ssvs::MusicPlayer musicPlayer;
+        LDSPSCQueue<LDAudioCommand, queueSize> queue;
+        LDWakeSignal wakeSignal;
+        std::atomic<bool> running{false};
+        std::atomic<float> soundVolume{100.f}, musicVolume{100.f};
+        std::thread thread;
+
+        inline void execute(const LDAudioCommand& mC)
+        {
+            using T = LDAudioCommand::Type;
+
+            switch(mC.type)
+            {
+                case T::PlaySound:
+                    soundPool.play(mC.sound, mC.mode, mC.value);
+                    break;
+                case T::PlayMusic:
+                    musicPlayer.play(*mC.music);
+                    musicPlayer.setLoop(true);
+                    break;
+                case T::StopMusic: musicPlayer.stop(); break;
+                case T::SetSoundVolume:
+                    soundPool.setVolume(mC.value);
+                    break;
+                case T::SetMusicVolume:
+                    musicPlayer.setVolume(mC.value);
+                    break;
+            }
+        }
+
+        inline void run()
+        {
+            LDAudioCommand c;
+            while(running)
+            {
+                while(queue.pop(c)) execute(c);
+                wakeSignal.wait([this]
+                    {
+                        return !queue.isEmpty() || !running;
+                    });
+            }
+
+            while(queue.pop(c)) execute(c);
+            soundPool.stop();
+            musicPlayer.stop();
+        }
+
+        inline void push(const LDAudioCommand& mC)
+        {
+            if(queue.push(mC)) wakeSignal.notify();
+        }
+
+    public:
+        inline ~LDAudio()
+        {
+            running = false;
+            wakeSignal.notify();
+            if(thread.joinable()) thread.join();
+        }
+
+        // Must be called once, after every sound buffer has been loaded
+        template <typename TAssetManager>
+        inline void start(TAssetManager& mAssetManager)
+        {
+            soundPool.resolve(mAssetManager);
+            running = true;
+            thread = std::thread{[this]
+                {
+                    run();
+                }};
+        }
+
+        inline void playSound(
+            LDSound mSound, LDSoundPool::Mode mMode, float mPitch)
+        {
+            push({LDAudioCommand::Type::PlaySound, mSound, mMode, mPitch,
+                nullptr});
+        }
+        inline void playMusic(sf::Music& mMusic)
+        {
+            push({LDAudioCommand::Type::PlayMusic, LDSound::Count,
+                LDSoundPool::Mode::Overlap, 0.f, &mMusic});
+        }
+        inline void stopMusic()
+        {
+            push({LDAudioCommand::Type::StopMusic, LDSound::Count,
+                LDSoundPool::Mode::Overlap, 0.f, nullptr});
+        }
+
+        // Volumes are mirrored on the simulation side, so reading them
+        // never touches the audio thread
+        inline void setSoundVolume(float mVolume)
+        {
+            soundVolume = mVolume;
+            push({LDAudioCommand::Type::SetSoundVolume, LDSound::Count,
+                LDSoundPool::Mode::Overlap, mVolume, nullptr});
+        }
+        inline void setMusicVolume(float mVolume)
+        {
+            musicVolume = mVolume;
+            push({LDAudioCommand::Type::SetMusicVolume, LDSound::Count,
+                LDSoundPool::Mode::Overlap, mVolume, nullptr});
+        }
+        inline float getSoundVolume() const noexcept { return soundVolume; }
+        inline float getMusicVolume() const noexcept { return musicVolume; }
+    };
+}
+
+#endif
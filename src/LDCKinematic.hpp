@@ -0,0 +1,71 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_COMPONENTS_KINEMATIC
+#define SSVLD_COMPONENTS_KINEMATIC
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    // Drives a lift along a scripted velocity or a looping path. The lift
+    // is a dynamic body with effectively infinite mass that checks no
+    // groups: the world integrates it like any other body, it is never
+    // resolved against anything, and riders resolving against it receive
+    // its velocity through velocity transfer.
+    class LDCKinematic : public sses::Component
+    {
+    private:
+        Body& body;
+        ssvs::Vec2f velocity;
+        std::vector<ssvs::Vec2i> path;
+        std::size_t target{0};
+        float speed{0.f};
+
+        inline void steer(FT mFT)
+        {
+            auto toTarget(ssvs::Vec2f(path[target] - body.getPosition()));
+            if(ssvs::getMag(toTarget) <= speed * mFT)
+            {
+                target = (target + 1) % path.size();
+                toTarget = ssvs::Vec2f(path[target] - body.getPosition());
+            }
+
+            velocity = ssvs::getMag(toTarget) > 0.f
+                           ? ssvs::getResized(toTarget, speed)
+                           : ssvs::zeroVec2f;
+        }
+
+    public:
+        inline LDCKinematic(
+            sses::Entity& mE, Body& mBody, const ssvs::Vec2f& mVelocity)
+            : sses::Component{mE}, body(mBody), velocity{mVelocity}
+        {
+        }
+
+        inline void update(FT mFT) override
+        {
+            if(!path.empty()) steer(mFT);
+            body.setVelocity(velocity);
+        }
+
+        inline void setVelocity(const ssvs::Vec2f& mVelocity) noexcept
+        {
+            velocity = mVelocity;
+        }
+        inline void setPath(std::vector<ssvs::Vec2i> mPath, float mSpeed)
+        {
+            path = std::move(mPath);
+            speed = mSpeed;
+            target = 0;
+        }
+
+        inline const ssvs::Vec2f& getVelocity() const noexcept
+        {
+            return velocity;
+        }
+    };
+}
+
+#endif
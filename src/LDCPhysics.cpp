@@ -28,34 +28,173 @@ namespace ld
 
         body.onDetection += [this](const DetectionInfo& mDI)
         {
-            if(mDI.userData == nullptr) return;
-            Entity* e(static_cast<Entity*>(mDI.userData));
-            onDetection(*e);
+            detect(mDI);
+            onBodyDetection(mDI);
         };
         body.onResolution += [this](const ResolutionInfo& mRI)
         {
-            onResolution(mRI.resolution);
-
-            lastResolution = mRI.resolution;
-            if(mRI.resolution.x > 0)
-                crushedLeft = crushedMax;
-            else if(mRI.resolution.x < 0)
-                crushedRight = crushedMax;
-            if(mRI.resolution.y > 0)
-                crushedTop = crushedMax;
-            else if(mRI.resolution.y < 0)
-                crushedBottom = crushedMax;
+            resolve(mRI);
+            onBodyResolution(mRI);
         };
         body.onPreUpdate += [this]
         {
-            groundSensor.setPosition(
-                body.getPosition() + Vec2i{0, body.getHeight() / 2});
-
-            lastResolution = ssvs::zeroVec2i;
-            if(crushedLeft > 0) --crushedLeft;
-            if(crushedRight > 0) --crushedRight;
-            if(crushedTop > 0) --crushedTop;
-            if(crushedBottom > 0) --crushedBottom;
+            preUpdate();
+            onPreUpdate();
         };
+        body.onPostUpdate += [this]
+        {
+            postUpdate();
+            onPostUpdate();
+        };
+    }
+
+    void LDCPhysics::detect(const DetectionInfo& mDI)
+    {
+        if(mDI.userData == nullptr) return;
+        Entity* e(static_cast<Entity*>(mDI.userData));
+        onDetection(*e);
+    }
+    void LDCPhysics::resolve(const ResolutionInfo& mRI)
+    {
+        onResolution(mRI.resolution);
+
+        lastResolution = mRI.resolution;
+        if(mRI.resolution.x > 0)
+            crushedLeft = crushedMax;
+        else if(mRI.resolution.x < 0)
+            crushedRight = crushedMax;
+        if(mRI.resolution.y > 0)
+            crushedTop = crushedMax;
+        else if(mRI.resolution.y < 0)
+            crushedBottom = crushedMax;
+    }
+    void LDCPhysics::preUpdate()
+    {
+        if(!active)
+        {
+            body.setVelocity(ssvs::zeroVec2f);
+            return;
+        }
+
+        groundSensor.setPosition(
+            body.getPosition() + Vec2i{0, body.getHeight() / 2});
+
+        lastResolution = ssvs::zeroVec2i;
+        if(crushedLeft > 0) --crushedLeft;
+        if(crushedRight > 0) --crushedRight;
+        if(crushedTop > 0) --crushedTop;
+        if(crushedBottom > 0) --crushedBottom;
+
+        if(sweepIndex != nullptr) sweep();
+    }
+    void LDCPhysics::postUpdate()
+    {
+        if(!active) return;
+
+        displayStress += (body.getStress() - displayStress) * stressBlend;
+
+        if(sweepScale == 1.f) return;
+
+        // Resolution already reflected/damped the scaled velocity
+        body.setVelocity(body.getVelocity() / sweepScale);
+        sweepScale = 1.f;
+    }
+
+    void LDCPhysics::setActive(bool mActive)
+    {
+        if(active == mActive || body.isStatic()) return;
+        active = mActive;
+
+        if(!active)
+        {
+            frozenVelocity = body.getVelocity();
+            body.setVelocity(ssvs::zeroVec2f);
+            body.delGroupsToCheck(LDGroup::Solid);
+            groundSensor.getSensor().delGroupsToCheck(LDGroup::Solid);
+            return;
+        }
+
+        body.setVelocity(frozenVelocity);
+        body.addGroupsToCheck(LDGroup::Solid);
+        groundSensor.getSensor().addGroupsToCheck(LDGroup::Solid);
+    }
+
+    float LDCPhysics::getTimeOfImpact(const Vec2f& mDisplacement) const
+    {
+        const Vec2f pos(body.getPosition());
+        const Vec2f halfSize(body.getWidth() / 2.f, body.getHeight() / 2.f);
+        const Vec2f sweptHalfSize{std::abs(mDisplacement.x) / 2.f + halfSize.x,
+            std::abs(mDisplacement.y) / 2.f + halfSize.y};
+        const auto sweptCenter(pos + mDisplacement / 2.f);
+        float result{1.f};
+
+        // Only the index cells covered by the swept bounds are visited
+        const Vec2i sweptMin(sweptCenter - sweptHalfSize),
+            sweptMax(sweptCenter + sweptHalfSize);
+        sweepIndex->forEach(sweptMin, sweptMax, [&](const Body& mOther)
+            {
+                if(!mOther.hasGroup(LDGroup::Solid)) return;
+
+                // Minkowski sum: sweep the center point against the other
+                // shape grown by our half size
+                const Vec2f otherPos(mOther.getPosition());
+                const Vec2f otherHalfSize(
+                    mOther.getWidth() / 2.f, mOther.getHeight() / 2.f);
+                const auto extent(otherHalfSize + halfSize);
+
+                if(std::abs(otherPos.x - sweptCenter.x) >=
+                        otherHalfSize.x + sweptHalfSize.x ||
+                    std::abs(otherPos.y - sweptCenter.y) >=
+                        otherHalfSize.y + sweptHalfSize.y)
+                    return;
+
+                float tEnter{0.f}, tExit{1.f};
+                bool miss{false};
+                for(int axis{0}; axis < 2; ++axis)
+                {
+                    const float p{axis == 0 ? pos.x : pos.y};
+                    const float d{
+                        axis == 0 ? mDisplacement.x : mDisplacement.y};
+                    const float o{axis == 0 ? otherPos.x : otherPos.y};
+                    const float e{axis == 0 ? extent.x : extent.y};
+
+                    if(d == 0.f)
+                    {
+                        if(std::abs(p - o) >= e) miss = true;
+                        continue;
+                    }
+
+                    float t0{(o - e - p) / d}, t1{(o + e - p) / d};
+                    if(t0 > t1) std::swap(t0, t1);
+                    tEnter = std::max(tEnter, t0);
+                    tExit = std::min(tExit, t1);
+                }
+
+                // Bodies already overlapping are left to the regular resolver
+                if(miss || tEnter >= tExit || tEnter <= 0.f) return;
+                result = std::min(result, tEnter);
+            });
+
+        return result;
+    }
+
+    void LDCPhysics::sweep()
+    {
+        const auto displacement(body.getVelocity() * lastFT);
+        const auto minHalfSize(
+            std::min(body.getWidth(), body.getHeight()) / 2.f);
+
+        // Slow bodies cannot skip past anything in a single step
+        if(std::abs(displacement.x) < minHalfSize &&
+            std::abs(displacement.y) < minHalfSize)
+            return;
+
+        const auto toi(getTimeOfImpact(displacement));
+        if(toi >= 1.f) return;
+
+        // Allow a shallow penetration so the resolver sees the contact
+        const auto length(ssvs::getMag(displacement));
+        sweepScale = std::min(1.f, toi + (minHalfSize / 2.f) / length);
+        body.setVelocity(body.getVelocity() * sweepScale);
     }
 }
@@ -6,6 +6,7 @@
 #define SSVLD_COMPONENTS_PHYSICS
 
 #include "LDSensor.hpp"
+#include "LDStaticIndex.hpp"
 #include "LDDependencies.hpp"
 
 namespace ld
@@ -26,18 +27,66 @@ namespace ld
         ssvs::Vec2f gravityForce{0, 25};
         LDSensor groundSensor;
 
+        // Continuous collision: fast bodies get their velocity scaled down
+        // for one step so they stop just inside the first wall or lift
+        // they would sweep through, then scaled back after resolution.
+        // Candidates come from `sweepIndex`, walls and lifts register in
+        // `index`
+        const LDStaticIndex* sweepIndex{nullptr};
+        LDStaticIndex* index{nullptr};
+        bool indexedMoving{false};
+        float sweepScale{1.f};
+        FT lastFT{1.f};
+
+        // Stress is rebuilt from scratch by every step's contacts, so it
+        // flickers as stacks settle. Gameplay reads the body's stress;
+        // labels show this persistent, blended copy. It is cosmetic, so
+        // state hashes and rewind frames leave it out
+        static constexpr float stressBlend{0.2f};
+        ssvs::Vec2f displayStress;
+
+        // Inactive bodies are frozen in place: no gravity, no collision
+        // queries of their own. Their velocity is kept for reactivation
+        bool active{true};
+        ssvs::Vec2f frozenVelocity;
+
+        // Set once a rewind frame holds this body: until then it must be
+        // captured even when resting, see `LDRewind`
+        bool recorded{false};
+
+        float getTimeOfImpact(const ssvs::Vec2f& mDisplacement) const;
+        void sweep();
+
+        void detect(const DetectionInfo& mDI);
+        void resolve(const ResolutionInfo& mRI);
+        void preUpdate();
+        void postUpdate();
+
     public:
-        ssvu::Delegate<void(sses::Entity&)> onDetection;
-        ssvu::Delegate<void(const ssvs::Vec2i&)> onResolution;
+        LDDelegate<void(sses::Entity&)> onDetection;
+        LDDelegate<void(const ssvs::Vec2i&)> onResolution;
+
+        // The body's own events, after this component handled them.
+        // Components and the factory subscribe here: the body's delegates
+        // only get one subscription each, from this component
+        LDDelegate<void(const DetectionInfo&)> onBodyDetection;
+        LDDelegate<void(const ResolutionInfo&)> onBodyResolution;
+        LDDelegate<void()> onPreUpdate, onPostUpdate;
 
         LDCPhysics(sses::Entity& mE, World& mWorld, bool mIsStatic,
             const ssvs::Vec2i& mPosition, const ssvs::Vec2i& mSize,
             bool mAffectedByGravity = true);
-        inline ~LDCPhysics() { body.destroy(); }
+        inline ~LDCPhysics()
+        {
+            if(index != nullptr) index->del(body, indexedMoving);
+            body.destroy();
+        }
 
 
-        inline void update(FT) override
+        inline void update(FT mFT) override
         {
+            lastFT = mFT;
+            if(!active) return;
             if(affectedByGravity && body.getVelocity().y < maxVelocityY)
                 body.applyAccel(gravityForce);
         }
@@ -46,15 +95,49 @@ namespace ld
         {
             affectedByGravity = mAffectedByGravity;
         }
+        // Frozen bodies keep it for reactivation, see `getVelocity`
+        inline void setVelocity(const ssvs::Vec2f& mVelocity)
+        {
+            if(active)
+                body.setVelocity(mVelocity);
+            else
+                frozenVelocity = mVelocity;
+        }
+        inline void setRecorded(bool mRecorded) { recorded = mRecorded; }
+        inline void setContinuous(const LDStaticIndex& mIndex)
+        {
+            sweepIndex = &mIndex;
+        }
+        // Static bodies, or `mMoving` ones that nothing pushes (lifts)
+        inline void addToIndex(LDStaticIndex& mIndex, bool mMoving)
+        {
+            index = &mIndex;
+            indexedMoving = mMoving;
+            index->add(body, mMoving);
+        }
+
+        void setActive(bool mActive);
 
         inline World& getWorld() const { return world; }
         inline Body& getBody() const { return body; }
         inline const ssvs::Vec2i& getPos() const { return body.getPosition(); }
+        inline const ssvs::Vec2f& getDisplayStress() const
+        {
+            return displayStress;
+        }
+        // Frozen bodies report the velocity they will resume with
+        inline const ssvs::Vec2f& getVelocity() const
+        {
+            return active ? body.getVelocity() : frozenVelocity;
+        }
         inline const ssvs::Vec2i& getLastResolution() const
         {
             return lastResolution;
         }
         inline bool isAffectedByGravity() const { return affectedByGravity; }
+        inline bool isContinuous() const { return sweepIndex != nullptr; }
+        inline bool isActive() const { return active; }
+        inline bool isRecorded() const { return recorded; }
         inline bool isCrushedLeft() const
         {
             return crushedLeft > crushedTolerance;
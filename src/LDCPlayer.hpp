@@ -21,19 +21,15 @@ namespace ld
         Body& body;
         LDCPhysics* parent{nullptr};
         ssvs::Vec2i offset;
-        ssvs::BitmapText text;
+        int label;
 
     public:
         LDCBlock(
             sses::Entity& mE, int mVal, LDGame& mGame, LDCPhysics& mCPhysics)
             : sses::Component{mE}, val(mVal), game(mGame), cPhysics(mCPhysics),
-              body(cPhysics.getBody()),
-              text{game.getAssets().get<ssvs::BitmapFont>("limeStroked"),
-                  ssvu::toStr(val)}
+              body(cPhysics.getBody()), label{val}
         {
-            text.setScale(0.75f, 0.75f);
-            text.setTracking(-3);
-            body.onResolution += [this](const ResolutionInfo& mRI)
+            cPhysics.onBodyResolution += [this](const ResolutionInfo& mRI)
             {
                 if(body.hasGroup(LDGroup::BlockFloating)) return;
 
@@ -41,9 +37,9 @@ namespace ld
                        mRI.resolution.x != 0) ||
                     (std::abs(body.getVelocity().y) > 400 &&
                         mRI.resolution.y != 0))
-                    game.getAssets().playSound("bounce.wav");
+                    game.getEvents().pushBounce(body.getPosition());
             };
-            body.onPreUpdate += [this]
+            cPhysics.onPreUpdate += [this]
             {
                 // body.setVelocity(ssvs::getCClamped(body.getVelocity(),
                 // -800.f,
@@ -65,12 +61,15 @@ namespace ld
                     if(parent == nullptr)
                         body.delGroupsNoResolve(LDGroup::Player);
                 }
-                text.setString(ssvu::toStr(ssvu::toInt(body.getStress().y)));
             };
 
-            body.onPostUpdate += [this]
+            cPhysics.onPostUpdate += [this]
             {
-                if(body.getStress().y > 10000) getEntity().destroy();
+                if(body.getStress().y > 10000 && getEntity().isAlive())
+                {
+                    getEntity().destroy();
+                    game.getEvents().pushCrush(body.getPosition());
+                }
                 // Global min/max velocity
                 // body.setVelocity(ssvs::getCClamped(body.getVelocity(),
                 // -800.f,
@@ -79,8 +78,7 @@ namespace ld
         }
         inline void update(FT) override
         {
-            text.setPosition(toPixels(body.getShape().getVertexNW<int>()) +
-                             ssvs::Vec2f{4, 3});
+            label = ssvu::toInt(cPhysics.getDisplayStress().y);
 
             if(parent != nullptr)
             {
@@ -96,7 +94,9 @@ namespace ld
         inline void draw() override
         {
             // if(val != -1)
-            game.render(text);
+            game.getLabels().add(
+                label, toPixels(body.getShape().getVertexNW<int>()) +
+                           ssvs::Vec2f{4, 3});
         }
 
         inline void pickedUp(LDCPhysics& mParent)
@@ -115,8 +115,22 @@ namespace ld
             body.setVelocity(ssvs::getCClamped(newVel, -1000.f, 1000.f));
             body.delGroups(LDGroup::BlockFloating);
         }
+        // Used when rewinding: no sounds and no timer side effects
+        inline void setParent(LDCPhysics* mParent)
+        {
+            if(parent == mParent) return;
+            parent = mParent;
+            if(parent != nullptr)
+            {
+                body.addGroups(LDGroup::BlockFloating);
+                body.addGroupsNoResolve(LDGroup::Player);
+            }
+            else
+                body.delGroups(LDGroup::BlockFloating);
+        }
         inline void setOffset(const ssvs::Vec2i& mOffset) { offset = mOffset; }
         inline bool hasParent() { return parent != nullptr; }
+        inline LDCPhysics* getParent() { return parent; }
         inline int getVal() { return val; }
     };
 
@@ -131,10 +145,19 @@ namespace ld
             Falling
         };
 
+        // Gameplay state that is not part of the body, for rewinding
+        struct State
+        {
+            Action action;
+            bool facingLeft;
+            float lastTurn, lastJump, stepTime, lastBlockTimer;
+        };
+
     private:
         LDGame& game;
         LDCPhysics& cPhysics;
         Body& body;
+        std::size_t channel; // Input channel driving this player
         Action action;
         bool facingLeft{false}, jumpReady{false};
         float walkSpeed{150.f}, jumpSpeed{520.f};
@@ -150,19 +173,21 @@ namespace ld
         float lastBlockTimer{0.f};
 
     public:
-        LDCPlayer(sses::Entity& mE, LDGame& mGame, LDCPhysics& mCPhysics)
+        LDCPlayer(sses::Entity& mE, LDGame& mGame, LDCPhysics& mCPhysics,
+            std::size_t mChannel = 0)
             : sses::Component{mE}, game(mGame), cPhysics(mCPhysics),
-              body(cPhysics.getBody())
+              body(cPhysics.getBody()), channel{mChannel}
         {
             blockSensor.getSensor().addGroupsToCheck(LDGroup::Block);
 
             blockSensor.onDetection += [this](sses::Entity& mDE)
             {
-                if(hasBlock() || !game.getIAction()) return;
+                if(hasBlock() || !game.getInput(channel).action) return;
                 if(!mDE.getComponent<LDCPhysics>().getBody().hasGroup(
                        LDGroup::CanBePicked))
                     return;
                 auto& block(mDE.getComponent<LDCBlock>());
+                if(block.hasParent()) return; // Carried by another player
                 block.pickedUp(cPhysics);
                 if(currentBlock != nullptr) currentBlock->dropped();
                 currentBlock = &block;
@@ -170,20 +195,14 @@ namespace ld
                 lastBlock = &mDE.getComponent<LDCPhysics>().getBody();
 
                 game.getAssets().playSound(
-                    "pick.wav", ssvs::SoundPlayer::Mode::Abort);
+                    LDSound::Pick, LDSoundPool::Mode::Abort);
             };
 
-            body.onPreUpdate += [this]
+            cPhysics.onPreUpdate += [this]
             {
                 jumpReady = false;
             };
-            body.onPostUpdate += [this]
-            {
-            };
-            body.onDetection += [this](const DetectionInfo&)
-            {
-            };
-            body.onResolution += [this](const ResolutionInfo& mRI)
+            cPhysics.onBodyResolution += [this](const ResolutionInfo& mRI)
             {
                 // When you get pushed in a floor/ceiling so hard that a fourth
                 // of
@@ -223,14 +242,15 @@ namespace ld
             blockSensor.setPosition(
                 body.getPosition() + ssvs::Vec2i{offset.x / 2, 300});
 
-            if(game.getIX() == 0)
+            const auto& input(game.getInput(channel));
+            if(input.x == 0)
                 move(0, mFT);
-            else if(game.getIX() == -1)
+            else if(input.x == -1)
                 move(-1, mFT);
-            else if(game.getIX() == 1)
+            else if(input.x == 1)
                 move(1, mFT);
 
-            if(game.getIJump() == 1) jump();
+            if(input.jump) jump();
 
             const auto& velocity(body.getVelocity());
 
@@ -264,10 +284,10 @@ namespace ld
             {
                 lastBlockTimer = 15.f;
 
-                if(!game.getIAction())
+                if(!input.action)
                 {
                     game.getAssets().playSound(
-                        "drop.wav", ssvs::SoundPlayer::Mode::Abort);
+                        LDSound::Drop, LDSoundPool::Mode::Abort);
                     currentBlock->dropped(
                         ((lastTurn > 0.f) ? lastTurn * 0.12f : 1.f),
                         ((lastJump > 0.f) ? lastJump * 0.12f : 1.f));
@@ -291,7 +311,7 @@ namespace ld
                     stepTime -= mFT;
                 else if(!cPhysics.isInAir())
                 {
-                    game.getAssets().playSound("step.wav");
+                    game.getAssets().playSound(LDSound::Step);
                     stepTime = 26.f;
                 }
             }
@@ -301,13 +321,36 @@ namespace ld
             if(cPhysics.isInAir() || lastJump > 0.f) return;
             body.setVelocityY(body.getVelocity().y - jumpSpeed);
             lastJump = 20.f;
-            game.getAssets().playSound("jump.wav");
+            game.getAssets().playSound(LDSound::Jump);
+        }
+
+        inline State getState() const
+        {
+            return {action, facingLeft, lastTurn, lastJump, stepTime,
+                lastBlockTimer};
+        }
+        inline void setState(const State& mState, LDCBlock* mBlock)
+        {
+            action = mState.action;
+            facingLeft = mState.facingLeft;
+            lastTurn = mState.lastTurn;
+            lastJump = mState.lastJump;
+            stepTime = mState.stepTime;
+            lastBlockTimer = mState.lastBlockTimer;
+
+            currentBlock = mBlock;
+            if(currentBlock == nullptr) return;
+            currentBlockStat = currentBlock->getEntity().getStat();
+            lastBlock = &currentBlock->getEntity()
+                             .getComponent<LDCPhysics>()
+                             .getBody();
         }
 
         inline Action getAction() { return action; }
         inline bool isJumpReady() { return jumpReady; }
         inline bool isFacingLeft() { return facingLeft; }
         inline bool hasBlock() { return currentBlock != nullptr; }
+        inline std::size_t getChannel() const noexcept { return channel; }
     };
 }
 
@@ -6,6 +6,8 @@
 #define SSVLD_COMPONENTS_PLAYERANIMATION
 
 #include "LDDependencies.hpp"
+#include "LDAtlas.hpp"
+#include "LDTimeSlice.hpp"
 #include "LDUtils.hpp"
 
 namespace ld
@@ -17,6 +19,8 @@ namespace ld
         LDCPlayer& cPlayer;
 
         ssvs::Tileset& tileset;
+        ssvs::Vec2i atlasOffset;
+        LDTimeSlice slice;
 
         ssvs::Animation animTorsoStand, animTorsoJump, animTorsoFall,
             animTorsoWalk, animTorsoHold;
@@ -26,9 +30,11 @@ namespace ld
 
     public:
         LDCPlayerAnimation(sses::Entity& mE, ssvs::Tileset& mTileset,
-            LDCRender& mCRender, LDCPlayer& mCPlayer)
+            const ssvs::Vec2i& mAtlasOffset, LDCRender& mCRender,
+            LDCPlayer& mCPlayer, unsigned int mSlicePhase)
             : sses::Component{mE}, cRender(mCRender), cPlayer(mCPlayer),
-              tileset(mTileset)
+              tileset(mTileset), atlasOffset{mAtlasOffset},
+              slice{LDRate::halfRate, mSlicePhase}
         {
             auto animsTorso(
                 ssvj::fromFile("Data/Animations/animCharTorso.json"));
@@ -61,6 +67,9 @@ namespace ld
         {
             using Action = LDCPlayer::Action;
 
+            if(!slice.update(mFT)) return;
+            const auto elapsed(slice.consume());
+
             cRender.setFlippedX(cPlayer.isFacingLeft());
             cRender.setGlobalOffset({0, -6});
 
@@ -88,16 +97,20 @@ namespace ld
 
             if(currentTorsoAnim != nullptr)
             {
-                currentTorsoAnim->update(mFT);
-                cRender[1].setTextureRect(
-                    tileset(currentTorsoAnim->getTileIndex()));
+                currentTorsoAnim->update(elapsed);
+                cRender.setTextureRect(
+                    1, LDAtlas::getOffsetRect(
+                           tileset(currentTorsoAnim->getTileIndex()),
+                           atlasOffset));
             }
 
             if(currentLegsAnim != nullptr)
             {
-                currentLegsAnim->update(mFT);
-                cRender[0].setTextureRect(
-                    tileset(currentLegsAnim->getTileIndex()));
+                currentLegsAnim->update(elapsed);
+                cRender.setTextureRect(
+                    0, LDAtlas::getOffsetRect(
+                           tileset(currentLegsAnim->getTileIndex()),
+                           atlasOffset));
             }
         }
     };
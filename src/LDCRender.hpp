@@ -23,6 +23,19 @@ namespace ld
         bool flippedX{false}, flippedY{false}, scaleWithBody{false};
         ssvs::Vec2f globalOffset;
 
+        // Sprite transforms are only rebuilt when the body moved or
+        // resized, or when a setter/sprite accessor touched them
+        bool dirty{true};
+        ssvs::Vec2i lastPosition, lastSize;
+
+        template <typename T, typename TV>
+        inline void setAndDirty(T& mMember, const TV& mValue) noexcept
+        {
+            if(mMember == mValue) return;
+            mMember = mValue;
+            dirty = true;
+        }
+
     public:
         inline LDCRender(sses::Entity& mE, LDGame& mGame, Body& mBody)
             : sses::Component{mE}, game(mGame), body(mBody)
@@ -31,8 +44,16 @@ namespace ld
 
         inline void update(FT) override
         {
-            const auto& position(toPixels(body.getPosition()));
-            const auto& size(toPixels(body.getSize()));
+            if(!dirty && lastPosition == body.getPosition() &&
+                lastSize == body.getSize())
+                return;
+
+            dirty = false;
+            lastPosition = body.getPosition();
+            lastSize = body.getSize();
+
+            const auto& position(toPixels(lastPosition));
+            const auto& size(toPixels(lastSize));
 
             for(auto i(0u); i < sprites.size(); ++i)
             {
@@ -57,27 +78,36 @@ namespace ld
         {
             sprites.emplace_back(FWD(mArgs)...);
             offsets.emplace_back();
+            dirty = true;
         }
 
         inline void setRotation(float mDegrees) noexcept
         {
             for(auto& s : sprites) s.setRotation(mDegrees);
+            dirty = true;
+        }
+        inline void setTextureRect(unsigned int mIdx, const sf::IntRect& mRect)
+        {
+            auto& s(sprites[mIdx]);
+            if(s.getTextureRect() == mRect) return;
+            s.setTextureRect(mRect);
+            dirty = true;
         }
         inline void setFlippedX(bool mFlippedX) noexcept
         {
-            flippedX = mFlippedX;
+            setAndDirty(flippedX, mFlippedX);
         }
         inline void setFlippedY(bool mFlippedY) noexcept
         {
-            flippedY = mFlippedY;
+            setAndDirty(flippedY, mFlippedY);
         }
         inline void setScaleWithBody(bool mScale) noexcept
         {
-            scaleWithBody = mScale;
+            setAndDirty(scaleWithBody, mScale);
         }
         inline void setGlobalOffset(const ssvs::Vec2f& mOffset) noexcept
         {
-            globalOffset = mOffset;
+            setAndDirty(globalOffset, mOffset);
         }
 
         inline bool isFlippedX() const noexcept { return flippedX; }
@@ -90,10 +120,19 @@ namespace ld
         {
             return offsets;
         }
-        inline decltype(sprites)& getSprites() noexcept { return sprites; }
-        inline decltype(offsets)& getOffsets() noexcept { return offsets; }
+        inline decltype(sprites)& getSprites() noexcept
+        {
+            dirty = true;
+            return sprites;
+        }
+        inline decltype(offsets)& getOffsets() noexcept
+        {
+            dirty = true;
+            return offsets;
+        }
         inline sf::Sprite& operator[](unsigned int mIdx)
         {
+            dirty = true;
             return sprites[mIdx];
         }
         inline const sf::Sprite& operator[](unsigned int mIdx) const
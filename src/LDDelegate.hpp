@@ -0,0 +1,111 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_DELEGATE
+#define SSVLD_DELEGATE
+
+#include <array>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ld
+{
+    template <typename TSignature>
+    class LDFunction;
+
+    // Callable stored inline: no heap allocation, and calling it is a
+    // single indirect call. Only small, trivially copyable callables fit,
+    // such as lambdas capturing `this` and a few values.
+    template <typename TR, typename... TArgs>
+    class LDFunction<TR(TArgs...)>
+    {
+    public:
+        static constexpr std::size_t capacity{3 * sizeof(void*)};
+
+    private:
+        using Invoker = TR (*)(const void*, TArgs...);
+
+        typename std::aligned_storage<capacity, alignof(void*)>::type storage;
+        Invoker invoker{nullptr};
+
+    public:
+        LDFunction() = default;
+
+        template <typename T>
+        inline LDFunction(const T& mFn) noexcept
+        {
+            static_assert(
+                sizeof(T) <= capacity && alignof(T) <= alignof(void*),
+                "callable too large for inline storage");
+            static_assert(std::is_trivially_copyable<T>::value &&
+                              std::is_trivially_destructible<T>::value,
+                "callable must be trivially copyable");
+
+            new(&storage) T(mFn);
+            invoker = [](const void* mStorage, TArgs... mArgs) -> TR
+            {
+                return (*static_cast<const T*>(mStorage))(
+                    std::forward<TArgs>(mArgs)...);
+            };
+        }
+
+        inline TR operator()(TArgs... mArgs) const
+        {
+            return invoker(&storage, std::forward<TArgs>(mArgs)...);
+        }
+        inline explicit operator bool() const noexcept
+        {
+            return invoker != nullptr;
+        }
+    };
+
+    template <typename TSignature, std::size_t TInline = 4>
+    class LDDelegate;
+
+    // Drop-in for `ssvu::Delegate` (`+=`, call): the first `TInline`
+    // subscribers live in a contiguous inline array, only further ones
+    // go to the heap
+    template <typename... TArgs, std::size_t TInline>
+    class LDDelegate<void(TArgs...), TInline>
+    {
+    private:
+        using Fn = LDFunction<void(TArgs...)>;
+
+        std::array<Fn, TInline> fns;
+        std::size_t count{0};
+        std::vector<Fn> overflow;
+
+    public:
+        template <typename T>
+        inline LDDelegate& operator+=(const T& mFn)
+        {
+            if(count < TInline)
+                fns[count++] = Fn{mFn};
+            else
+                overflow.emplace_back(mFn);
+            return *this;
+        }
+
+        template <typename... TCallArgs>
+        inline void operator()(TCallArgs&&... mArgs) const
+        {
+            for(auto i(0u); i < count; ++i) fns[i](mArgs...);
+            for(const auto& f : overflow) f(mArgs...);
+        }
+
+        inline void clear() noexcept
+        {
+            count = 0;
+            overflow.clear();
+        }
+        inline std::size_t size() const noexcept
+        {
+            return count + overflow.size();
+        }
+    };
+}
+
+#endif
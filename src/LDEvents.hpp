@@ -0,0 +1,79 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_EVENTS
+#define SSVLD_EVENTS
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    // Gameplay side effects of contacts are recorded here during
+    // `world.update` and consumed afterwards, one batch per event kind.
+    // Only callbacks that must change resolution run inside the step.
+
+    struct LDEvBounce
+    {
+        ssvs::Vec2i position;
+    };
+
+    struct LDEvReceive
+    {
+        sses::Entity* block;
+    };
+
+    struct LDEvCrush
+    {
+        ssvs::Vec2i position;
+    };
+
+    class LDEventQueue
+    {
+    private:
+        std::vector<LDEvBounce> bounces;
+        std::vector<LDEvReceive> receives;
+        std::vector<LDEvCrush> crushes;
+        bool tele{false}; // Any player reached a teleporter
+
+    public:
+        inline void pushBounce(const ssvs::Vec2i& mPos)
+        {
+            bounces.push_back({mPos});
+        }
+        inline void pushReceive(sses::Entity& mBlock)
+        {
+            receives.push_back({&mBlock});
+        }
+        inline void pushCrush(const ssvs::Vec2i& mPos)
+        {
+            crushes.push_back({mPos});
+        }
+        inline void pushTele() noexcept { tele = true; }
+
+        inline const decltype(bounces)& getBounces() const noexcept
+        {
+            return bounces;
+        }
+        inline const decltype(receives)& getReceives() const noexcept
+        {
+            return receives;
+        }
+        inline const decltype(crushes)& getCrushes() const noexcept
+        {
+            return crushes;
+        }
+        inline bool hasTele() const noexcept { return tele; }
+
+        // Keeps capacity, so steady-state steps do not allocate
+        inline void clear() noexcept
+        {
+            bounces.clear();
+            receives.clear();
+            crushes.clear();
+            tele = false;
+        }
+    };
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include "LDGroups.hpp"
 
 #include "LDCPhysics.hpp"
+#include "LDCKinematic.hpp"
 #include "LDCRender.hpp"
 #include "LDCPlayer.hpp"
 #include "LDCPlayerAnimation.hpp"
@@ -26,12 +27,14 @@ namespace ld
     Sprite LDFactory::getSpriteFromTile(
         const std::string& mTextureId, const IntRect& mTextureRect) const
     {
-        return {assets.get<Texture>(mTextureId), mTextureRect};
+        return {
+            assets.atlas.getTexture(), assets.atlas(mTextureId, mTextureRect)};
     }
     void LDFactory::emplaceSpriteFromTile(LDCRender& mCDraw,
         const std::string& mTextureId, const sf::IntRect& mTextureRect) const
     {
-        mCDraw.emplaceSprite(assets.get<Texture>(mTextureId), mTextureRect);
+        mCDraw.emplaceSprite(
+            assets.atlas.getTexture(), assets.atlas(mTextureId, mTextureRect));
     }
 
     Entity& LDFactory::createWall(const Vec2i& mPos)
@@ -45,6 +48,7 @@ namespace ld
         Body& body(cPhysics.getBody());
         body.addGroups(LDGroup::Solid);
         body.addGroupsToCheck(LDGroup::Solid);
+        cPhysics.addToIndex(game.getStaticIndex(), false);
         body.setVelTransferMultX(1.f);
         body.setVelTransferMultY(1.f);
 
@@ -71,6 +75,7 @@ namespace ld
         body.addGroups(LDGroup::Solid, LDGroup::Block);
         body.addGroupsToCheck(LDGroup::Solid);
         body.addGroupsNoResolve(LDGroup::BlockFloating);
+        cPhysics.setContinuous(game.getStaticIndex());
         return result;
     }
     Entity& LDFactory::createBlock(const Vec2i& mPos, int mVal)
@@ -209,7 +214,7 @@ namespace ld
         return result;
     }
 
-    Entity& LDFactory::createPlayer(const Vec2i& mPos)
+    Entity& LDFactory::createPlayer(const Vec2i& mPos, std::size_t mChannel)
     {
         auto& result(manager.createEntity());
         result.addGroups(LDGroup::Player);
@@ -217,9 +222,11 @@ namespace ld
             world, false, mPos, Vec2i{800, 2700}));
         auto& cRender(
             result.createComponent<LDCRender>(game, cPhysics.getBody()));
-        auto& cPlayer(result.createComponent<LDCPlayer>(game, cPhysics));
-        result.createComponent<LDCPlayerAnimation>(
-            assets.tilesetChar, cRender, cPlayer);
+        auto& cPlayer(
+            result.createComponent<LDCPlayer>(game, cPhysics, mChannel));
+        result.createComponent<LDCPlayerAnimation>(assets.tilesetChar,
+            assets.atlas.getOffset("charTiles.png"), cRender, cPlayer,
+            game.getNextSlicePhase());
 
         Body& body(cPhysics.getBody());
         body.addGroups(LDGroup::Solid, LDGroup::Player);
@@ -229,8 +236,10 @@ namespace ld
         body.setRestitutionY(0.f);
         body.setMass(1.f);
 
-        cRender.emplaceSprite(assets.get<Texture>("charTiles.png"));
-        cRender.emplaceSprite(assets.get<Texture>("charTiles.png"));
+        emplaceSpriteFromTile(
+            cRender, "charTiles.png", assets.tilesetChar(0, 0));
+        emplaceSpriteFromTile(
+            cRender, "charTiles.png", assets.tilesetChar(0, 0));
         cRender.setScaleWithBody(false);
 
         result.setDrawPriority(-1000);
@@ -240,6 +249,7 @@ namespace ld
     Entity& LDFactory::createReceiver(const Vec2i& mPos, int mVal)
     {
         auto& result(manager.createEntity());
+        result.addGroups(LDGroup::Receiver);
         auto& cPhysics(result.createComponent<LDCPhysics>(
             world, false, mPos, Vec2i{1600, 1600}));
         cPhysics.setAffectedByGravity(false);
@@ -251,18 +261,13 @@ namespace ld
         body.addGroupsToCheck(LDGroup::Block);
         body.setResolve(false);
 
-        body.onDetection += [this, mVal](const DetectionInfo& mDI)
+        cPhysics.onBodyDetection += [this, mVal](const DetectionInfo& mDI)
         {
             if(!mDI.body.hasGroup(LDGroup::Block)) return;
             auto& entity(*static_cast<Entity*>(mDI.userData));
 
             if(mVal == -1 || (mVal == entity.getComponent<LDCBlock>().getVal()))
-            {
-                game.getAssets().playSound(
-                    "recv.wav", SoundPlayer::Mode::Override);
-                entity.destroy();
-                this->game.refresh10Secs();
-            }
+                game.getEvents().pushReceive(entity);
         };
 
         emplaceSpriteFromTile(
@@ -282,6 +287,7 @@ namespace ld
     Entity& LDFactory::createTele(const Vec2i& mPos)
     {
         auto& result(manager.createEntity());
+        result.addGroups(LDGroup::Tele);
         auto& cPhysics(result.createComponent<LDCPhysics>(
             world, false, mPos, Vec2i{1600, 100}));
         cPhysics.setAffectedByGravity(false);
@@ -292,48 +298,52 @@ namespace ld
         body.addGroupsToCheck(LDGroup::Player);
         body.setResolve(false);
 
-        body.onDetection += [this](const DetectionInfo& mDI)
+        cPhysics.onBodyDetection += [this](const DetectionInfo& mDI)
         {
-            if(!mDI.body.hasGroup(LDGroup::Player)) return;
-
-            if(manager.getEntityCount(LDGroup::Block) == 0)
-            {
-                game.nextLevel();
-                game.getAssets().playSound(
-                    "tele.wav", SoundPlayer::Mode::Override);
-            }
+            if(mDI.body.hasGroup(LDGroup::Player)) game.getEvents().pushTele();
         };
 
         emplaceSpriteFromTile(
             cRender, "worldTiles.png", assets.tilesetWorld(6, 0));
         return result;
     }
-    Entity& LDFactory::createLift(const Vec2i& mPos, const Vec2f& mVel)
+    Entity& LDFactory::createLiftBase(const Vec2i& mPos)
     {
         auto& result(manager.createEntity());
-        result.addGroups(LDGroup::Block);
+        result.addGroups(LDGroup::Lift);
         auto& cPhysics(result.createComponent<LDCPhysics>(
-            world, false, mPos, Vec2i{3200, 1800}));
+            world, false, mPos, Vec2i{3200, 1800}, false));
         auto& cRender(
             result.createComponent<LDCRender>(game, cPhysics.getBody()));
 
+        // Nothing can push a lift: it checks no groups and outweighs
+        // anything that resolves against it
         Body& body(cPhysics.getBody());
         body.addGroups(LDGroup::Solid);
-        body.addGroupsToCheck(LDGroup::Solid);
-        body.addGroupsNoResolve(LDGroup::BlockFloating);
-        cPhysics.setAffectedByGravity(false);
-        body.onPreUpdate += [&, mVel]
-        {
-            body.setVelocity(mVel * 2.f);
-        };
-        body.setRestitutionX(0.3f);
-        body.setRestitutionY(0.3f);
-        body.setMass(10.f);
+        body.setMass(1000000.f);
         body.setVelTransferMultX(1.f);
         body.setVelTransferMultY(1.f);
+        cPhysics.addToIndex(game.getStaticIndex(), true);
 
         emplaceSpriteFromTile(
             cRender, "worldTiles.png", assets.tilesetWorld(0, 1));
         return result;
     }
+    Entity& LDFactory::createLift(const Vec2i& mPos, const Vec2f& mVel)
+    {
+        auto& result(createLiftBase(mPos));
+        result.createComponent<LDCKinematic>(
+            result.getComponent<LDCPhysics>().getBody(), mVel * 2.f);
+        return result;
+    }
+    Entity& LDFactory::createLift(std::vector<Vec2i> mPath, float mSpeed)
+    {
+        // The lift starts on the first waypoint
+        SSVU_ASSERT(!mPath.empty());
+        auto& result(createLiftBase(mPath.front()));
+        auto& cKinematic(result.createComponent<LDCKinematic>(
+            result.getComponent<LDCPhysics>().getBody(), zeroVec2f));
+        cKinematic.setPath(std::move(mPath), mSpeed);
+        return result;
+    }
 }
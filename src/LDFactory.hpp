@@ -31,6 +31,7 @@ namespace ld
 
         sses::Entity& createBlockBase(
             const ssvs::Vec2i& mPos, const ssvs::Vec2i& mSize, int mVal = -1);
+        sses::Entity& createLiftBase(const ssvs::Vec2i& mPos);
 
     public:
         LDFactory(LDAssets& mAssets, LDGame& mGame, sses::Manager& mManager,
@@ -47,11 +48,15 @@ namespace ld
             const ssvs::Vec2i& mPos, int mVal = -1);
         sses::Entity& createBlockRubberV(
             const ssvs::Vec2i& mPos, int mVal = -1);
-        sses::Entity& createPlayer(const ssvs::Vec2i& mPos);
+        sses::Entity& createPlayer(
+            const ssvs::Vec2i& mPos, std::size_t mChannel = 0);
         sses::Entity& createReceiver(const ssvs::Vec2i& mPos, int mVal = -1);
         sses::Entity& createTele(const ssvs::Vec2i& mPos);
         sses::Entity& createLift(
             const ssvs::Vec2i& mPos, const ssvs::Vec2f& mVel);
+        // Loops over `mPath`, which needs at least one waypoint
+        sses::Entity& createLift(
+            std::vector<ssvs::Vec2i> mPath, float mSpeed);
     };
 }
 
@@ -0,0 +1,132 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_FRAMEPACER
+#define SSVLD_FRAMEPACER
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include "LDDependencies.hpp"
+#include "LDHistogram.hpp"
+
+namespace ld
+{
+    // Holds every frame to a target frame time. OS sleeps overshoot, so
+    // only the bulk of the wait is slept: the last `spinMargin` is spun.
+    // The margin follows the overshoot actually observed. Frames that run
+    // late are not caught up on, the schedule restarts from them.
+    // Intervals between paced frames go into a histogram. In sleep-only
+    // mode (idle screens), the whole wait is slept and nothing recorded.
+    class LDFramePacer
+    {
+    private:
+        using Clock = std::chrono::steady_clock;
+        using Us = std::chrono::microseconds;
+
+        static constexpr long long minMarginUs{500}, maxMarginUs{4000};
+
+        Us target;
+        Us spinMargin{2000};
+        Clock::time_point next, last;
+        bool started{false}, sleepOnly{false};
+        LDHistogram frameTimes{500, 0.1f};
+
+        inline static float toMs(Clock::duration mDuration) noexcept
+        {
+            return std::chrono::duration_cast<Us>(mDuration).count() /
+                   1000.f;
+        }
+
+    public:
+        inline LDFramePacer(float mTargetMs) { setTargetMs(mTargetMs); }
+
+        inline void setTargetMs(float mTargetMs) noexcept
+        {
+            target = Us{static_cast<long long>(mTargetMs * 1000.f)};
+        }
+        inline float getTargetMs() const noexcept
+        {
+            return target.count() / 1000.f;
+        }
+        inline void setSleepOnly(bool mSleepOnly) noexcept
+        {
+            sleepOnly = mSleepOnly;
+        }
+
+        // Blocks until the next frame is due
+        inline void pace()
+        {
+            auto now(Clock::now());
+            if(!started)
+            {
+                started = true;
+                next = last = now;
+            }
+
+            next += target;
+            if(next < now) next = now;
+
+            const auto remaining(next - now);
+            if(sleepOnly)
+            {
+                std::this_thread::sleep_for(remaining);
+                last = Clock::now();
+                return;
+            }
+
+            if(remaining > spinMargin)
+            {
+                const auto request(remaining - spinMargin);
+                std::this_thread::sleep_for(request);
+
+                // Leave room for the worst recent overshoot
+                const long long overshoot{std::chrono::duration_cast<Us>(
+                    Clock::now() - now - request).count()},
+                    decayed{static_cast<long long>(spinMargin.count()) * 63 /
+                            64};
+                spinMargin = Us{std::min(
+                    std::max({decayed, overshoot * 5 / 4, minMarginUs}),
+                    maxMarginUs)};
+            }
+
+            while((now = Clock::now()) < next)
+                ;
+
+            frameTimes.add(toMs(now - last));
+            last = now;
+        }
+
+        inline void clear() noexcept { frameTimes.clear(); }
+        inline const LDHistogram& getFrameTimes() const noexcept
+        {
+            return frameTimes;
+        }
+
+        // Writes the percentiles, then one "<bucket ms> <count>" per line
+        inline bool dump(const std::string& mPath) const
+        {
+            std::ofstream o{mPath};
+            if(!o) return false;
+
+            o << "target " << getTargetMs() << "\n"
+              << "frames " << frameTimes.getCount() << "\n"
+              << "p50 " << frameTimes.getPercentile(0.5f) << "\n"
+              << "p99 " << frameTimes.getPercentile(0.99f) << "\n"
+              << "p99.9 " << frameTimes.getPercentile(0.999f) << "\n"
+              << "max " << frameTimes.getMax() << "\n";
+
+            const auto& buckets(frameTimes.getBuckets());
+            for(auto i(0u); i < buckets.size(); ++i)
+                if(buckets[i] > 0)
+                    o << i * frameTimes.getBucketMs() << " " << buckets[i]
+                      << "\n";
+
+            return static_cast<bool>(o);
+        }
+    };
+}
+
+#endif
@@ -2,11 +2,14 @@
 // License: Academic Free License ("AFL") v. 3.0
 // AFL License page: http://opensource.org/licenses/AFL-3.0
 
+#include <tuple>
+
 #include "LDGame.hpp"
 #include "LDMenu.hpp"
 #include "LDGroups.hpp"
 #include "LDCPhysics.hpp"
 #include "LDCPlayer.hpp"
+#include "LDRewind.hpp"
 
 using namespace std;
 using namespace sf;
@@ -24,7 +27,12 @@ namespace ld
     LDGame::LDGame(GameWindow& mGameWindow, LDAssets& mAssets)
         : gameWindow(mGameWindow), assets(mAssets),
           factory{assets, *this, manager, world}, world(1000, 1000, 3000, 500),
-          debugText{assets.get<BitmapFont>("limeStroked")},
+          stream{factory, manager},
+          labels{assets.get<BitmapFont>("limeStroked"),
+              assets.atlas.getTexture(),
+              assets.atlas.getOffset("limeStroked.png"), 0.75f, -3},
+          renderSink{ssvu::mkUPtr<LDWindowSink>(gameWindow)},
+          rewind{ssvu::mkUPtr<LDRewind>()},
           msgText{assets.get<BitmapFont>("limeStroked")},
           timerText{assets.get<BitmapFont>("limeStroked")}
     {
@@ -37,14 +45,19 @@ namespace ld
         gameState.onDraw += [this]
         {
             draw();
+            framePacer.pace(); // Right before the window displays
         };
 
         // Let's make the text prettier
-        debugText.setTracking(-3);
-        msgText.setTracking(-3);
-        msgText.setScale(2.f, 2.f);
-        timerText.setTracking(-3);
-        timerText.setScale(4.f, 4.f);
+        debugLines.reserve(debugLineCount);
+        for(auto i(0u); i < debugLineCount; ++i)
+        {
+            debugLines.emplace_back(assets.get<BitmapFont>("limeStroked"));
+            debugLines.back().getText().setTracking(-3);
+        }
+        msgText.getText().setTracking(-3);
+        msgText.getText().setScale(2.f, 2.f);
+        timerText.getText().setTracking(-3);
 
         // Input initialization
         using k = ssvs::KKey;
@@ -53,7 +66,9 @@ namespace ld
 
         gameState.addInput({{k::Escape}}, [this](FT)
             {
-                assets.musicPlayer.stop();
+                if(menuGame == nullptr) return; // Headless
+                assets.stopMusic();
+                menuGame->wake();
                 gameWindow.setGameState(menuGame->gameState);
             });
 
@@ -91,97 +106,141 @@ namespace ld
         gameState.addInput({{k::R}},
             [this](FT)
             {
-                newGame();
+                if(canAlterSimulation()) newGame();
             },
             t::Once);
 
-        gameState.addInput({{k::Num1}},
+        gameState.addInput({{k::BackSpace}}, [this](FT)
+            {
+                rewinding = canAlterSimulation();
+            });
+        gameState.addInput({{k::F8}},
             [this](FT)
             {
-                factory.createWall(getMousePosition());
+                toggleSpectator();
             },
             t::Once);
-        gameState.addInput({{k::Num2}},
+        gameState.addInput({{k::F9}},
             [this](FT)
             {
-                factory.createBlock(getMousePosition(), getRndI(0, 10));
+                toggleViewer();
             },
             t::Once);
-        gameState.addInput({{k::Num3}},
+        gameState.addInput({{k::F10}},
             [this](FT)
             {
-                factory.createPlayer(getMousePosition());
+                hostCoop();
             },
             t::Once);
-        gameState.addInput({{k::Num4}},
+        gameState.addInput({{k::F11}},
             [this](FT)
             {
-                factory.createBlock(getMousePosition());
+                joinCoop();
             },
             t::Once);
-        gameState.addInput({{k::Num5}},
+        gameState.addInput({{k::F12}},
             [this](FT)
             {
-                factory.createReceiver(getMousePosition(), getRndI(0, 10));
+                const auto dumped(framePacer.dump("frametimes.txt"));
+                showMessage(dumped ? "frame times saved"
+                                   : "could not save frame times",
+                    100, dumped ? Color::Green : Color::Red);
             },
             t::Once);
-        gameState.addInput({{k::Num6}},
+
+        // Traces restart the level, so they are off while co-op is active
+        gameState.addInput({{k::F6}},
             [this](FT)
             {
-                factory.createReceiver(getMousePosition());
+                if(!lockstep.isActive()) toggleHashRecording();
             },
             t::Once);
-        gameState.addInput({{k::Num7}},
+        gameState.addInput({{k::F7}},
             [this](FT)
             {
-                factory.createBlockBig(getMousePosition());
+                if(!lockstep.isActive()) startHashVerifying();
             },
             t::Once);
-        gameState.addInput({{k::Num8}},
-            [this](FT)
+
+        auto addDebugInput([this](k mKey, std::function<void()> mAction)
+            {
+                gameState.addInput({{mKey}},
+                    [this, mAction](FT)
+                    {
+                        if(canAlterSimulation()) mAction();
+                    },
+                    t::Once);
+            });
+        addDebugInput(k::F5, [this]
+            {
+                checkLevels();
+            });
+
+        addDebugInput(k::Num1, [this]
+            {
+                factory.createWall(getMousePosition());
+            });
+        addDebugInput(k::Num2, [this]
+            {
+                factory.createBlock(getMousePosition(), getRndI(0, 10));
+            });
+        addDebugInput(k::Num3, [this]
+            {
+                factory.createPlayer(getMousePosition());
+            });
+        addDebugInput(k::Num4, [this]
+            {
+                factory.createBlock(getMousePosition());
+            });
+        addDebugInput(k::Num5, [this]
+            {
+                factory.createReceiver(getMousePosition(), getRndI(0, 10));
+            });
+        addDebugInput(k::Num6, [this]
+            {
+                factory.createReceiver(getMousePosition());
+            });
+        addDebugInput(k::Num7, [this]
+            {
+                factory.createBlockBig(getMousePosition());
+            });
+        addDebugInput(k::Num8, [this]
             {
                 factory.createBlockBall(getMousePosition());
-            },
-            t::Once);
-        gameState.addInput({{k::Num9}},
-            [this](FT)
+            });
+        addDebugInput(k::Num9, [this]
             {
                 factory.createBlockRubberH(getMousePosition());
-            },
-            t::Once);
-        gameState.addInput({{k::Num0}},
-            [this](FT)
+            });
+        addDebugInput(k::Num0, [this]
             {
                 factory.createBlockRubberV(getMousePosition());
-            },
-            t::Once);
-        gameState.addInput({{k::J}},
-            [this](FT)
+            });
+        addDebugInput(k::J, [this]
             {
                 factory.createLift(getMousePosition(), Vec2f{-100, 0});
-            },
-            t::Once);
-        gameState.addInput({{k::L}},
-            [this](FT)
+            });
+        addDebugInput(k::L, [this]
             {
                 factory.createLift(getMousePosition(), Vec2f{100, 0});
-            },
-            t::Once);
-        gameState.addInput({{k::I}},
-            [this](FT)
+            });
+        addDebugInput(k::I, [this]
             {
                 factory.createLift(getMousePosition(), Vec2f{0, -100});
-            },
-            t::Once);
-        gameState.addInput({{k::K}},
-            [this](FT)
+            });
+        addDebugInput(k::K, [this]
             {
                 factory.createLift(getMousePosition(), Vec2f{0, 100});
-            },
-            t::Once);
+            });
     }
+    LDGame::~LDGame() = default;
 
-    void LDGame::start10Secs() { levelStatus.started = true; }
+    void LDGame::start10Secs()
+    {
+        if(levelStatus.started) return;
+        levelStatus.started = true;
+        scripts.signal(LDSignal::LevelStarted);
+    }
     void LDGame::refresh10Secs() { levelStatus.timer.resetAll(); }
 
     void LDGame::showMessage(
@@ -193,30 +252,50 @@ namespace ld
         msgText.setColor(mColor);
     }
 
-    void LDGame::newGame()
+    void LDGame::clearLevel()
     {
-        // Cleanup
         manager.clear();
-        timelineManager.clear();
+        stream.clear();
+        scripts.clear();
         levelStatus = LDLevelStatus{};
         msgCharTimer.resetAll();
         msgTimer.resetAll();
+        rewind->clear();
+        activityTimer.resetAll();
+        slicePhase = 0;
+    }
+    void LDGame::loadLevel()
+    {
+        if(generated)
+            levelGenerated();
+        else
+            switch(level)
+            {
+                case 0: levelOne(); break;
+                case 1: levelTwo(); break;
+                case 2: levelThree(); break;
+                case 3: levelFour(); break;
+                case 4: levelFive(); break;
+                case 5: levelSix(); break;
+                case 6: levelSeven(); break;
+            }
+    }
+    void LDGame::newGame()
+    {
+        clearLevel();
+        loadLevel();
+        spawnPlayers();
+        spectator.setSession(getSession());
 
-        // Level loading
-        switch(level)
-        {
-            case 0: levelOne(); break;
-            case 1: levelTwo(); break;
-            case 2: levelThree(); break;
-            case 3: levelFour(); break;
-            case 4: levelFive(); break;
-            case 5: levelSix(); break;
-            case 6: levelSeven(); break;
-        }
+        // The first chunks must exist before the first step
+        updateStream();
     }
     void LDGame::nextLevel()
     {
-        level = level < levelCount ? level + 1 : 0;
+        if(generated)
+            ++genSettings.seed;
+        else
+            level = level < levelCount ? level + 1 : 0;
         mustChangeLevel = true;
     }
 
@@ -226,21 +305,48 @@ namespace ld
     {
         return Vec2i(sX + 3200 * mX, sY + 3200 * mY);
     }
-    Entity& LDGame::pW(int mX, int mY)
+    void LDGame::spawnPlayers()
     {
-        return factory.createWall(put(mX, mY));
+        factory.createPlayer(spawn);
+        if(lockstep.isRunning())
+            factory.createPlayer(spawn + Vec2i{900, 0}, 1);
     }
-    Entity& LDGame::pB(int mX, int mY, int mVal)
+
+    // Level tiles are streamed in by chunk, see `updateStream`
+    void LDGame::place(LDRecordKind mKind, int mX, int mY, int mVal)
     {
-        return factory.createBlock(put(mX, mY), mVal);
+        if(capturing != nullptr)
+            capturing->records.push_back(
+                {mKind, put(mX, mY), zeroVec2f, mVal});
+        else
+            stream.add(mKind, put(mX, mY), mVal);
     }
-    Entity& LDGame::pR(int mX, int mY, int mVal)
+    void LDGame::pP(int mX, int mY)
     {
-        return factory.createReceiver(put(mX, mY), mVal);
+        (capturing != nullptr ? capturing->spawn : spawn) = put(mX, mY);
     }
-    Entity& LDGame::pT(int mX, int mY)
+    void LDGame::pW(int mX, int mY) { place(LDRecordKind::Wall, mX, mY); }
+    void LDGame::pB(int mX, int mY, int mVal, LDRecordKind mKind)
     {
-        return factory.createTele(put(mX, mY));
+        place(mKind, mX, mY, mVal);
+    }
+    void LDGame::pR(int mX, int mY, int mVal)
+    {
+        place(LDRecordKind::Receiver, mX, mY, mVal);
+    }
+    void LDGame::pT(int mX, int mY) { place(LDRecordKind::Tele, mX, mY); }
+    void LDGame::pL(const std::vector<Vec2i>& mPath, float mSpeed)
+    {
+        std::vector<Vec2i> path;
+        for(const auto& p : mPath) path.emplace_back(put(p.x, p.y));
+
+        if(capturing != nullptr)
+        {
+            capturing->lifts.emplace_back(std::move(path));
+            capturing->liftSpeeds.emplace_back(mSpeed);
+            return;
+        }
+        factory.createLift(std::move(path), mSpeed);
     }
 
     void LDGame::levelOne()
@@ -256,12 +362,12 @@ namespace ld
             pW(i, 0);
             pW(0, -i);
         }
-        auto& player(factory.createPlayer(put(1, -1)));
-        const auto& pBody(player.getComponent<LDCPhysics>().getBody());
+        pP(1, -1);
 
         auto pCrateX(sX + 20000);
-        auto& pCrate(factory.createBlock(put(5, -1)));
-        auto& pReceiver(factory.createReceiver(put(10, 1)));
+        const auto pCrateStart(put(5, -1)), pReceiverPos(put(10, 1));
+        pB(5, -1);
+        pR(10, 1);
 
         pW(19, -6);
         pW(19, -5);
@@ -293,29 +399,56 @@ namespace ld
         pW(17, 2);
         pW(18, 2);
 
-        const auto& pCrateBody(pCrate.getComponent<LDCPhysics>().getBody());
-        const auto& pReceiverBody(
-            pReceiver.getComponent<LDCPhysics>().getBody());
-
-        auto intro([=, &pBody]
+        auto intro([=]
             {
-                return pBody.getPosition().x < pCrateX - 5000 &&
+                const auto player(getLocalPlayer());
+                return player != nullptr &&
+                       player->getComponent<LDCPhysics>()
+                               .getBody()
+                               .getPosition()
+                               .x < pCrateX - 5000 &&
                        (msgTimer.isRunning() || !msgText.getString().empty());
             });
-        auto crateNotPlaced([=, &pCrateBody, &pReceiverBody]
-            { /* check if crate is alive here */
-                return getDistEuclidean(pCrateBody.getPosition(),
-                           pReceiverBody.getPosition()) > 3200;
+
+        // The training crate is looked up once the stream created it; the
+        // whole level stays loaded, so it keeps its entity until it is
+        // delivered or crushed
+        struct Crate
+        {
+            Entity* entity{nullptr};
+            EntityStat stat;
+            bool placed{false};
+        };
+        auto pCrate(std::make_shared<Crate>());
+        auto crateNotPlaced([=]
+            {
+                if(pCrate->entity == nullptr ||
+                    !manager.isAlive(pCrate->stat) ||
+                    !pCrate->entity->isAlive())
+                    return false;
+
+                pCrate->placed =
+                    getDistEuclidean(
+                        pCrate->entity->getComponent<LDCPhysics>().getPos(),
+                        pReceiverPos) <= 3200;
+                return !pCrate->placed;
             });
 
-        auto& t(timelineManager.create());
-        t.append<Do>([=]
+        auto& t(scripts.create());
+        t.then([=]
             {
+                for(auto& e : manager.getEntities(LDGroup::Block))
+                    if(e->getComponent<LDCPhysics>().getPos() == pCrateStart)
+                    {
+                        pCrate->entity = e;
+                        pCrate->stat = e->getStat();
+                    }
+
                 showMessage(
                     "10corp welcomes you, worker #" + rndWorkerHash, 150);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage("#" + rndWorkerHash +
                                 ", you have been selected because of "
@@ -323,35 +456,35 @@ namespace ld
                                 "quality_3>",
                     150);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage("but your real strengths, #" + rndWorkerHash +
                                 ", are your speed,\nyour agility, your "
                                 "dedition to work",
                     150);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage(
                     "you should know how much 10corp values speed\nand quick "
                     "thinking",
                     150);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage("here are the standard protocols to follow", 150);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage("1. 10corp is your home, your workplace, your life",
                     150, Color::Red);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage(
                     "2. 10corp values speed: slow workers will be "
@@ -359,8 +492,8 @@ namespace ld
                     "of mankind",
                     150, Color::Red);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage(
                     "3. 10corp values intelligence: inept workers will "
@@ -368,24 +501,34 @@ namespace ld
                     "the good of mankind",
                     150, Color::Red);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage(
                     "proceed to your right for the standard newcomer training",
                     150, Color::White);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro);
+        t.then([=]
             {
                 showMessage(
                     "place the 10corp standardized cratestorage in the\n10corp "
                     "standardized cratereceiver to continue",
                     -1, Color::Green);
             });
-        t.append<WaitWhile>(crateNotPlaced);
-        t.append<Do>([=]
+        t.waitWhile(
+            crateNotPlaced, LDSignal::BlockReceived, LDSignal::BlockCrushed);
+        t.then([=]
             {
+                if(!pCrate->placed)
+                {
+                    showMessage(
+                        "10corp standardized cratestorage destroyed\npress "
+                        "'R' to restart the training",
+                        -1, Color::Red);
+                    return;
+                }
+
                 showMessage(
                     "assigment successful\nplace remaining cratestorages "
                     "and\nproceed to "
@@ -405,10 +548,9 @@ namespace ld
             pW(i, 0);
             pW(0, -i);
         }
-        auto& player(factory.createPlayer(put(1, -1)));
-        const auto& pBody(player.getComponent<LDCPhysics>().getBody());
+        pP(1, -1);
 
-        auto intro([=, &pBody]
+        auto intro([=]
             {
                 return !levelStatus.started &&
                        (msgTimer.isRunning() || !msgText.getString().empty());
@@ -440,19 +582,21 @@ namespace ld
         pW(12, 5);
         pW(13, 5);
 
-        auto& t(timelineManager.create());
-        t.append<Do>([=]
+        auto& t(scripts.create());
+        t.then([=]
             {
                 showMessage("welcome back, worker", 150);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(
+            intro, LDSignal::MessageFinished, LDSignal::LevelStarted);
+        t.then([=]
             {
                 showMessage(
                     "10corp does not tolerate slowness", 150, Color::Red);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(
+            intro, LDSignal::MessageFinished, LDSignal::LevelStarted);
+        t.then([=]
             {
                 showMessage(
                     "after grabbing the first cratestorage, you\nwill only "
@@ -460,7 +604,8 @@ namespace ld
                     "before\nyour termination",
                     150, Color::Red);
             });
-        t.append<WaitWhile>(intro);
+        t.waitWhile(
+            intro, LDSignal::MessageFinished, LDSignal::LevelStarted);
     }
 
     void LDGame::levelThree()
@@ -472,10 +617,9 @@ namespace ld
             pW(i, 0);
             pW(0, -i);
         }
-        auto& player(factory.createPlayer(put(1, -1)));
-        const auto& pBody(player.getComponent<LDCPhysics>().getBody());
+        pP(1, -1);
 
-        auto intro([=, &pBody]
+        auto intro([=]
             {
                 return (msgTimer.isRunning() || !msgText.getString().empty());
             });
@@ -503,19 +647,19 @@ namespace ld
         pW(17, 4);
 
 
-        auto& t(timelineManager.create());
-        t.append<Do>([=]
+        auto& t(scripts.create());
+        t.then([=]
             {
                 showMessage("speed is everything, worker", 150);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro, LDSignal::MessageFinished);
+        t.then([=]
             {
                 showMessage(
                     "10corp does not tolerate slowness", 150, Color::Red);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro, LDSignal::MessageFinished);
+        t.then([=]
             {
                 showMessage(
                     "do not be afraid to throw 10corp standardized "
@@ -523,7 +667,7 @@ namespace ld
                     "speeds up your tasks",
                     150, Color::Red);
             });
-        t.append<WaitWhile>(intro);
+        t.waitWhile(intro, LDSignal::MessageFinished);
     }
 
     void LDGame::levelFour()
@@ -535,10 +679,9 @@ namespace ld
             pW(i, 0);
             pW(0, -i);
         }
-        auto& player(factory.createPlayer(put(1, -1)));
-        const auto& pBody(player.getComponent<LDCPhysics>().getBody());
+        pP(1, -1);
 
-        auto intro([=, &pBody]
+        auto intro([=]
             {
                 return (msgTimer.isRunning() || !msgText.getString().empty());
             });
@@ -572,27 +715,27 @@ namespace ld
         pW(18, 4);
 
 
-        auto& t(timelineManager.create());
-        t.append<Do>([=]
+        auto& t(scripts.create());
+        t.then([=]
             {
                 showMessage(
                     "not every cratestorage can be automatically sorted, "
                     "worker",
                     150);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro, LDSignal::MessageFinished);
+        t.then([=]
             {
                 showMessage(
                     "10corp does not tolerate mistakes", 150, Color::Red);
             });
-        t.append<WaitWhile>(intro);
-        t.append<Do>([=]
+        t.waitWhile(intro, LDSignal::MessageFinished);
+        t.then([=]
             {
                 showMessage(
                     "the white cratereceivers accept everything, though", 150);
             });
-        t.append<WaitWhile>(intro);
+        t.waitWhile(intro, LDSignal::MessageFinished);
     }
 
     void LDGame::levelFive()
@@ -604,10 +747,9 @@ namespace ld
             pW(i, 0);
             pW(0, -i);
         }
-        auto& player(factory.createPlayer(put(1, -1)));
-        const auto& pBody(player.getComponent<LDCPhysics>().getBody());
+        pP(1, -1);
 
-        auto intro([=, &pBody]
+        auto intro([=]
             {
                 return (msgTimer.isRunning() || !msgText.getString().empty());
             });
@@ -644,14 +786,14 @@ namespace ld
         pW(10, 6);
         pW(11, 6);
 
-        auto& t(timelineManager.create());
-        t.append<Do>([=]
+        auto& t(scripts.create());
+        t.then([=]
             {
                 showMessage(
                     "of course, 10corp assumes you can use your\nbrain, too",
                     150);
             });
-        t.append<WaitWhile>(intro);
+        t.waitWhile(intro, LDSignal::MessageFinished);
     }
 
     void LDGame::levelSix()
@@ -663,10 +805,9 @@ namespace ld
             pW(i, 0);
             pW(0, -i);
         }
-        auto& player(factory.createPlayer(put(1, -1)));
-        const auto& pBody(player.getComponent<LDCPhysics>().getBody());
+        pP(1, -1);
 
-        auto intro([=, &pBody]
+        auto intro([=]
             {
                 return (msgTimer.isRunning() || !msgText.getString().empty());
             });
@@ -709,8 +850,8 @@ namespace ld
         pW(12, 8);
 
 
-        auto& t(timelineManager.create());
-        t.append<Do>([=]
+        auto& t(scripts.create());
+        t.then([=]
             {
                 showMessage(
                     "10corp standardized cratestorages are not fragile\nuse "
@@ -718,7 +859,7 @@ namespace ld
                     "environment to complete your tasks",
                     150);
             });
-        t.append<WaitWhile>(intro);
+        t.waitWhile(intro, LDSignal::MessageFinished);
     }
 
     void LDGame::levelSeven()
@@ -730,10 +871,9 @@ namespace ld
             pW(i, 0);
             pW(0, -i);
         }
-        auto& player(factory.createPlayer(put(1, -1)));
-        const auto& pBody(player.getComponent<LDCPhysics>().getBody());
+        pP(1, -1);
 
-        auto intro([=, &pBody]
+        auto intro([=]
             {
                 return (msgTimer.isRunning() || !msgText.getString().empty());
             });
@@ -771,32 +911,129 @@ namespace ld
         pW(18, 6);
 
 
-        auto& t(timelineManager.create());
-        t.append<Do>([=]
+        auto& t(scripts.create());
+        t.then([=]
             {
                 showMessage(
                     "this is your final task for today\ngood luck, worker",
                     150);
             });
-        t.append<WaitWhile>(intro);
+        t.waitWhile(intro, LDSignal::MessageFinished);
+    }
+
+    void LDGame::levelGenerated()
+    {
+        levelStatus.title = "generated #" + toStr(genSettings.seed);
+
+        LDLevelGenerator generator{genSettings};
+        generator.generate(*this);
+
+        const auto& spawnTile(generator.getSpawn());
+        pP(spawnTile.x, spawnTile.y);
+
+        const auto seed(genSettings.seed);
+        const auto tiles(generator.getTileCount());
+        auto& t(scripts.create());
+        t.then([=]
+            {
+                showMessage("10corp automated facility #" + toStr(seed) +
+                                "\n" + toStr(tiles) + " tiles",
+                    150);
+            });
+    }
+
+    LDLevelData LDGame::captureLevel()
+    {
+        LDLevelData result;
+
+        // Scripts and status created by the builder are thrown away
+        const auto oldStatus(levelStatus);
+        auto oldScripts(std::move(scripts));
+        scripts.clear();
+        levelStatus = LDLevelStatus{};
+
+        capturing = &result;
+        loadLevel();
+        capturing = nullptr;
+
+        result.title = levelStatus.title;
+        result.timed = !levelStatus.tutorial;
+
+        scripts = std::move(oldScripts);
+        levelStatus = oldStatus;
+        return result;
+    }
+    bool LDGame::checkLevels()
+    {
+        const auto oldLevel(level);
+        const auto oldGenerated(generated);
+        const auto oldSettings(genSettings);
+
+        std::vector<LDLevelData> levels;
+        for(int i{0}; i <= levelCount; ++i)
+        {
+            setLevel(i);
+            levels.emplace_back(captureLevel());
+        }
+        for(int i{0}; i < 8; ++i)
+        {
+            auto settings(oldSettings);
+            settings.seed += i;
+            setGenerated(settings);
+            levels.emplace_back(captureLevel());
+        }
+
+        level = oldLevel;
+        generated = oldGenerated;
+        genSettings = oldSettings;
+
+        const auto reports(LDSolver::checkAll(levels));
+
+        std::size_t solvable{0};
+        for(const auto& r : reports)
+        {
+            if(r.isSolvable()) ++solvable;
+            ssvu::lo("Solver") << r.title << ": "
+                               << (r.isSolvable() ? "ok" : "FAILED")
+                               << " (blocks: " << r.blocks
+                               << ", unreachable: " << r.unreachable
+                               << ", undeliverable: " << r.undeliverable
+                               << ", late: " << r.late << ", worst: "
+                               << r.worstDelivery << "s, tele: "
+                               << r.teleReachable << ")\n";
+        }
+
+        const auto passed(solvable == reports.size());
+        showMessage("levels checked: " + toStr(solvable) + "/" +
+                        toStr(reports.size()) + " solvable",
+            150, passed ? Color::Green : Color::Red);
+        return passed;
     }
 
     void LDGame::update(FT mFT)
     {
+        if(!updateLockstep())
+        {
+            // Stalled: the step waits for the peer's input
+            camera.update(mFT);
+            return;
+        }
+
         if(levelStatus.started && !levelStatus.tutorial)
         {
             levelStatus.timer.resume();
 
             if(levelStatus.timer.update(mFT))
-                assets.playSound("blip.wav", SoundPlayer::Mode::Overlap,
+                assets.playSound(LDSound::Blip, LDSoundPool::Mode::Overlap,
                     levelStatus.timer.getTicks() - 3.f);
 
             if(levelStatus.timer.getTotalSecs() > 10.f)
             {
                 if(manager.getEntityCount(LDGroup::Player) > 0)
                 {
-                    manager.getEntities(LDGroup::Player)[0]->destroy();
-                    assets.playSound("death.wav");
+                    for(auto& p : manager.getEntities(LDGroup::Player))
+                        p->destroy();
+                    assets.playSound(LDSound::Death);
                 }
 
                 timerText.setString("too slow");
@@ -804,30 +1041,33 @@ namespace ld
             else if(levelStatus.timer.getTotalSecs() < 10.f)
             {
                 timerText.setColor(Color::Red);
-                timerText.setString(
-                    toStr(10.f - levelStatus.timer.getTotalSecs()));
+                timerText.format(
+                    "%.2f", 10.f - levelStatus.timer.getTotalSecs());
             }
 
             auto grow = levelStatus.timer.getTotalSecs() * 0.4f;
-            timerText.setScale(4.f + grow, 4.f + grow);
+            setTimerTextScale(4.f + grow);
         }
         else
         {
             levelStatus.timer.pause();
             timerText.setColor(Color::Blue);
             timerText.setString(levelStatus.tutorial ? "tutorial" : "safe");
-            timerText.setScale(4.f, 4.f);
+            setTimerTextScale(4.f);
         }
-        timerText.setPosition(
-            {0.f, gameWindow.getHeight() - timerText.getGlobalBounds().height});
 
-        // Message control
-        if(msgTimer.isRunning() &&
-            msgText.getString().size() < currentMsg.size())
+        // Layout only depends on contents and scale
+        if(timerText.consumeChanged())
+            timerText.getText().setPosition({0.f,
+                gameWindow.getHeight() -
+                    timerText.getText().getGlobalBounds().height});
+
+        // Message control: `msgText` always shows a prefix of `currentMsg`
+        const auto msgShown(msgText.getString().size());
+        if(msgTimer.isRunning() && msgShown < currentMsg.size())
         {
             if(msgCharTimer.update(mFT, 2.f))
-                msgText.setString(msgText.getString() +
-                                  currentMsg[msgText.getString().size()]);
+                msgText.setPrefix(currentMsg, msgShown + 1);
         }
         else if(msgTimer.update(mFT))
             msgTimer.stop();
@@ -835,23 +1075,48 @@ namespace ld
         if(!msgTimer.isRunning() && !msgText.getString().empty())
         {
             if(msgCharTimer.update(mFT, 0.6f))
-                msgText.setString(msgText.getString().substr(
-                    0, msgText.getString().size() - 1));
+            {
+                msgText.setPrefix(currentMsg, msgText.getString().size() - 1);
+                if(msgText.getString().empty())
+                    scripts.signal(LDSignal::MessageFinished);
+            }
         }
 
-        timelineManager.update(
-            mFT);            // TimelineManager is from SSVUtils, it handles
-                             // coroutine-like timeline objects
-        manager.update(mFT); // Manager is from SSVEntitySystem, it handles
-                             // entities and components
-        world.update(mFT); // World is from SSVSCollision, it handles "physics"
-        updateDebugText(
-            mFT); // And debugText is just a debugging text showing FPS
-                  // and other cool info
-
-        if(manager.hasEntity(LDGroup::Player))
+        scripts.update();    // Level scripts: only polling waits cost
+                             // anything here, signal waits are suspended
+        if(activityTimer.update(mFT))
+        {
+            updateStream();
+            updateActivity();
+        }
+        if(rewinding)
+        {
+            // Plays back at twice the speed, nothing is simulated
+            rewinding = false;
+            rewind->restore(
+                manager, levelStatus.timer, levelStatus.started, 2);
+        }
+        else
+        {
+            manager.update(mFT); // Manager is from SSVEntitySystem, it
+                                 // handles entities and components
+            world.update(mFT);   // World is from SSVSCollision, it handles
+                                 // "physics"
+            processEvents();     // Contact side effects recorded during the
+                                 // step
+            rewind->capture(
+                manager, levelStatus.timer, levelStatus.started);
+            updateHash();
+        }
+        spectator.capture(manager); // Rewound states are streamed too
+        viewer.poll();
+        if(debugTextTimer.update(mFT))
+            updateDebugText(mFT); // And debugLines are just debugging text
+                                  // showing FPS and other cool info
+
+        auto player(getLocalPlayer());
+        if(player != nullptr)
         {
-            auto& player(manager.getEntities(LDGroup::Player)[0]);
             auto& cPhysics(player->getComponent<LDCPhysics>());
             auto& cPlayer(player->getComponent<LDCPlayer>());
             auto pPos(toPixels(cPhysics.getPos()));
@@ -860,7 +1125,7 @@ namespace ld
             camera.pan(-(camera.getCenter() - (pPos + panVec)) / 40.f);
         }
 
-        if(!manager.hasEntity(LDGroup::Block)) levelStatus.started = false;
+        if(!hasBlocks()) levelStatus.started = false;
 
         if(mustChangeLevel)
         {
@@ -869,10 +1134,300 @@ namespace ld
         }
 
         camera.update(mFT);
+
+        // Sounds from far outside the view are culled
+        const auto& viewSize(camera.getView().getSize());
+        const auto cullSize(toCoords(viewSize * 2.f));
+        const auto cullCenter(toCoords(camera.getCenter()));
+        assets.setSoundCullRect({Vec2f(cullCenter - cullSize / 2),
+            Vec2f(cullSize)});
+    }
+    std::array<Vec2i, 2> LDGame::getFocus()
+    {
+        // Only the players decide what is simulated, never the camera:
+        // panning or zooming must not change the outcome of a replay or a
+        // co-op game. Alone, both points follow the local player
+        std::array<Vec2i, 2> result{{spawn, spawn}};
+        for(auto& e : manager.getEntities(LDGroup::Player))
+            result[e->getComponent<LDCPlayer>().getChannel()] =
+                e->getComponent<LDCPhysics>().getPos();
+
+        if(!lockstep.isRunning()) result[1] = result[0];
+        return result;
+    }
+    Vec2i LDGame::getFocusExtent()
+    {
+        // The default view's size, whatever the current zoom
+        return toCoords(Vec2f{400.f, 300.f});
+    }
+    void LDGame::updateStream()
+    {
+        // Loaded chunks must cover the whole simulated region (see
+        // `updateActivity`) with some margin, so that awake blocks never
+        // lose the walls they rest on
+        stream.update(getFocus(), getFocusExtent() * 2);
+    }
+    void LDGame::updateActivity()
+    {
+        // Blocks are only simulated near the players; the margin between
+        // the wake and sleep regions avoids toggling blocks that sit right
+        // on the border
+        const auto viewSize(getFocusExtent());
+        const Vec2i wakeExtent{viewSize}, sleepExtent{viewSize * 3 / 2};
+        const auto centers(getFocus());
+
+        auto isWithin([&centers](const Vec2i& mPos, const Vec2i& mExtent)
+            {
+                for(const auto& c : centers)
+                    if(std::abs(mPos.x - c.x) <= mExtent.x &&
+                        std::abs(mPos.y - c.y) <= mExtent.y)
+                        return true;
+                return false;
+            });
+
+        for(auto& e : manager.getEntities(LDGroup::Block))
+        {
+            auto& cPhysics(e->getComponent<LDCPhysics>());
+            const auto& pos(cPhysics.getPos());
+
+            if(cPhysics.isActive())
+            {
+                if(!isWithin(pos, sleepExtent)) cPhysics.setActive(false);
+            }
+            else if(isWithin(pos, wakeExtent))
+                cPhysics.setActive(true);
+        }
+    }
+    void LDGame::updateHash()
+    {
+        stateHash.compute(manager);
+
+        if(hashMode == HashMode::Recording)
+            hashTrace.record(stateHash, inputs[0]);
+        else if(hashMode == HashMode::Verifying)
+        {
+            LDHashTrace::Divergence d;
+            if(hashTrace.verify(stateHash, d)) return;
+            hashMode = HashMode::Off;
+
+            if(d.step >= hashTrace.getStepCount())
+            {
+                showMessage("trace verified: " + toStr(d.step) + " steps",
+                    150, Color::Green);
+                return;
+            }
+
+            string where{"body count"};
+            if(d.body != static_cast<std::size_t>(-1))
+            {
+                const auto& pos(stateHash.getEntity(d.body)
+                                    .getComponent<LDCPhysics>()
+                                    .getPos());
+                where = "body #" + toStr(d.body) + " at " + toStr(pos.x) +
+                        ", " + toStr(pos.y);
+            }
+
+            ssvu::lo("Hash") << "First divergence at step " << d.step
+                             << ": " << where << "\n";
+            showMessage("desync at step " + toStr(d.step) + "\n" + where,
+                150, Color::Red);
+        }
+    }
+    void LDGame::toggleHashRecording()
+    {
+        if(hashMode == HashMode::Recording)
+        {
+            hashMode = HashMode::Off;
+            const auto saved(hashTrace.save("hashtrace.bin"));
+            showMessage(saved ? "trace saved: " +
+                                    toStr(hashTrace.getStepCount()) + " steps"
+                              : "could not save trace",
+                150, saved ? Color::Green : Color::Red);
+            return;
+        }
+
+        // Traces always start from a freshly loaded level
+        hashTrace.clear();
+        newGame();
+        hashMode = HashMode::Recording;
+    }
+    void LDGame::startHashVerifying()
+    {
+        if(!hashTrace.load("hashtrace.bin"))
+        {
+            showMessage("could not load trace", 150, Color::Red);
+            return;
+        }
+
+        newGame();
+        hashMode = HashMode::Verifying;
+    }
+    void LDGame::toggleSpectator()
+    {
+        if(spectator.isRunning())
+        {
+            spectator.stop();
+            showMessage("spectator server stopped", 100);
+            return;
+        }
+
+        if(spectator.start())
+            showMessage("spectators can connect on port " +
+                            toStr(LDSpectator::defaultPort),
+                150, Color::Green);
+        else
+            showMessage("could not start spectator server", 150, Color::Red);
+    }
+    void LDGame::toggleViewer()
+    {
+        if(viewer.isConnected())
+        {
+            viewer.disconnect();
+            return;
+        }
+
+        if(!viewer.connect(sf::IpAddress::LocalHost))
+            showMessage("no local spectator server", 150, Color::Red);
+    }
+    void LDGame::hostCoop()
+    {
+        if(lockstep.isActive())
+        {
+            lockstep.stop();
+            return;
+        }
+
+        sf::Packet session;
+        session << getSession();
+
+        if(lockstep.host(session))
+            showMessage("waiting for a co-op partner on port " +
+                            toStr(LDLockstep::defaultPort),
+                150, Color::Green);
+        else
+            showMessage("could not host co-op", 150, Color::Red);
+    }
+    void LDGame::joinCoop()
+    {
+        if(lockstep.isActive())
+        {
+            lockstep.stop();
+            return;
+        }
+
+        if(!lockstep.join(sf::IpAddress::LocalHost))
+            showMessage("no local co-op host", 150, Color::Red);
+    }
+    bool LDGame::updateLockstep()
+    {
+        LDInput local;
+        local.action = inputAction;
+        local.jump = inputJump;
+        local.x = inputX;
+        local.y = inputY;
+
+        switch(lockstep.poll())
+        {
+            case LDLockstep::Event::Started:
+                startSession(lockstep.getSession());
+                break;
+            case LDLockstep::Event::Lost:
+                showMessage("co-op partner lost", 150, Color::Red);
+                break;
+            case LDLockstep::Event::None: break;
+        }
+
+        // Still playing alone while waiting for a partner. A verified
+        // trace replays its own inputs, whatever the keyboard does
+        if(!lockstep.isRunning())
+        {
+            inputs.fill(LDInput{});
+            inputs[0] =
+                hashMode == HashMode::Verifying ? hashTrace.getInput() : local;
+            return true;
+        }
+
+        // Stalls skip the whole step, so both peers simulate the same ones
+        return lockstep.advance(local, inputs);
+    }
+    void LDGame::startSession(sf::Packet& mSession)
+    {
+        // Traces are single-player: the peer's inputs are not recorded
+        hashMode = HashMode::Off;
+
+        LDSession session;
+        mSession >> session;
+        level = session.level;
+        generated = session.generated;
+        genSettings = session.genSettings;
+
+        // Messages signal level scripts: both peers start without one
+        msgTimer.stop();
+        msgText.setString("");
+        newGame();
+    }
+    Entity* LDGame::getLocalPlayer()
+    {
+        for(auto& e : manager.getEntities(LDGroup::Player))
+            if(e->getComponent<LDCPlayer>().getChannel() ==
+                lockstep.getLocalChannel())
+                return e;
+        return nullptr;
+    }
+    bool LDGame::hasBlocks()
+    {
+        return manager.hasEntity(LDGroup::Block) || stream.hasStoredBlocks();
+    }
+    void LDGame::processEvents()
+    {
+        // The pool rate-limits bounces, so only the first audible one counts
+        for(const auto& b : events.getBounces())
+            if(assets.isAudible(b.position))
+            {
+                assets.playSound(LDSound::Bounce);
+                break;
+            }
+
+        for(const auto& r : events.getReceives())
+        {
+            // A block can touch more than one receiver in a single step:
+            // destroying it marks it as handled. Blocks crushed during the
+            // step were never delivered
+            auto& block(*r.block);
+            if(!block.isAlive()) continue;
+
+            assets.playSoundAt(LDSound::Recv,
+                block.getComponent<LDCPhysics>().getPos(),
+                LDSoundPool::Mode::Override);
+            refresh10Secs();
+
+            // Scripts still see the delivered block, where it touched the
+            // receiver
+            scripts.signal(LDSignal::BlockReceived);
+            block.destroy();
+        }
+
+        if(!events.getCrushes().empty())
+            scripts.signal(LDSignal::BlockCrushed);
+
+        // However many players touched it, the level only advances once
+        if(events.hasTele() && !hasBlocks())
+        {
+            nextLevel();
+            assets.playSound(LDSound::Tele, LDSoundPool::Mode::Override);
+        }
+
+        events.clear();
+    }
+    void LDGame::setTimerTextScale(float mScale)
+    {
+        if(timerTextScale == mScale) return;
+        timerTextScale = mScale;
+        timerText.getText().setScale(mScale, mScale);
+        timerText.invalidate();
     }
     void LDGame::updateDebugText(FT mFT)
     {
-        ostringstream s;
         const auto& entities(manager.getEntities());
         const auto& bodies(world.getBodies());
         const auto& sensors(world.getSensors());
@@ -882,28 +1437,234 @@ namespace ld
         for(const auto& b : bodies)
             if(!b->isStatic()) ++dynamicBodiesCount;
 
-        s << "FPS: " << gameWindow.getFPS() << "\n";
-        s << "FrameTime: " << mFT << "\n";
-        s << "Bodies(all): " << bodies.size() << "\n";
-        s << "Bodies(static): " << bodies.size() - dynamicBodiesCount << "\n";
-        s << "Bodies(dynamic): " << dynamicBodiesCount << "\n";
-        s << "Sensors: " << sensors.size() << "\n";
-        s << "Entities: " << entities.size() << "\n";
-        s << "Components: " << componentCount << "\n";
-
-        if(manager.getEntityCount(LDGroup::Block) == 0)
-            s << "SAFE: NO BLOCKS\n";
+        debugLines[0].format(
+            "FPS: %d\nFrameTime: %.3f", toInt(gameWindow.getFPS()), mFT);
+        debugLines[1].format(
+            "Bodies(all): %zu\nBodies(static): %zu\nBodies(dynamic): %zu",
+            bodies.size(), bodies.size() - dynamicBodiesCount,
+            dynamicBodiesCount);
+        debugLines[2].format("Sensors: %zu\nEntities: %zu\nComponents: %zu",
+            sensors.size(), entities.size(), componentCount);
+        debugLines[3].format("Chunks: %zu/%zu\nHash: %016llx",
+            stream.getLoadedCount(), stream.getChunkCount(),
+            static_cast<unsigned long long>(stateHash.getTotal()));
+        debugLines[4].format("Spectators: %zu (%zuKB, %zu dropped)",
+            spectator.getClientCount(), spectator.getBytesSent() / 1024,
+            spectator.getFramesDropped());
+
+        const auto& session(viewer.getSession());
+        debugLines[5].format("Viewer: %zu bodies, step %u, %s %u",
+            viewer.getBodies().size(),
+            static_cast<unsigned int>(viewer.getStep()),
+            session.generated ? "seed" : "level",
+            session.generated ? session.genSettings.seed
+                              : static_cast<unsigned int>(session.level));
+
+        const auto& latency(lockstep.getLatency());
+        debugLines[6].format(
+            "Co-op: frame %u, latency %.1f/%.1f/%.1fms, %zu stalls",
+            static_cast<unsigned int>(lockstep.getFrame()),
+            latency.getPercentile(0.5f), latency.getPercentile(0.99f),
+            latency.getMax(), lockstep.getStalls());
+
+        const auto& lastFrame(renderSink->getLastFrame());
+        const auto& frameTimes(framePacer.getFrameTimes());
+        debugLines[7].format(
+            "Draw: %zu calls, %zu vertices, %zu switches\n"
+            "Frame p50/p99/p99.9: %.1f/%.1f/%.1fms",
+            lastFrame.drawCalls, lastFrame.vertices,
+            lastFrame.textureSwitches, frameTimes.getPercentile(0.5f),
+            frameTimes.getPercentile(0.99f), frameTimes.getPercentile(0.999f));
+        debugLines[8].setString(hasBlocks() ? "" : "SAFE: NO BLOCKS");
+
+        layoutDebugText();
+    }
+    void LDGame::layoutDebugText()
+    {
+        bool changed{false};
+        for(auto& l : debugLines) changed = l.consumeChanged() || changed;
+        if(!changed) return;
 
-        debugText.setString(s.str());
+        float y{0.f};
+        for(auto& l : debugLines)
+        {
+            l.getText().setPosition({0.f, y});
+            if(!l.getString().empty())
+                y += l.getText().getGlobalBounds().height;
+        }
     }
 
     void LDGame::draw()
     {
+        renderSink->beginFrame();
         camera.apply<int>();
         manager.draw();
+        render(labels);
+        labels.clear();
         camera.unapply();
-        render(debugText);
+        for(const auto& l : debugLines) render(l);
         render(msgText);
         render(timerText);
+
+        renderSink->endFrame();
+        checkRenderBudget();
+    }
+    void LDGame::checkRenderBudget()
+    {
+        const auto& stats(renderSink->getLastFrame());
+        if(!renderBudget.isExceeded(stats)) return;
+
+        if(overBudgetFrames++ == 0)
+            ssvu::lo("Render") << "Over budget: " << stats.drawCalls
+                               << " draw calls, " << stats.vertices
+                               << " vertices, " << stats.textureSwitches
+                               << " texture switches\n";
+    }
+    bool LDGame::benchmarkRender(std::size_t mFrames)
+    {
+        setRenderSink(ssvu::mkUPtr<LDNullSink>());
+        overBudgetFrames = 0;
+
+        const auto oldLevel(level);
+        const auto oldGenerated(generated);
+        sf::Clock clock;
+        LDHistogram drawTimes{100, 0.1f};
+
+        for(int l{0}; l <= levelCount; ++l)
+        {
+            setLevel(l);
+            newGame();
+
+            LDRenderStats worst;
+            for(auto i(0u); i < mFrames; ++i)
+            {
+                update(1.f);
+
+                clock.restart();
+                draw();
+                drawTimes.add(clock.getElapsedTime().asMicroseconds() /
+                              1000.f);
+
+                const auto& stats(renderSink->getLastFrame());
+                worst.drawCalls = std::max(worst.drawCalls, stats.drawCalls);
+                worst.vertices = std::max(worst.vertices, stats.vertices);
+                worst.textureSwitches =
+                    std::max(worst.textureSwitches, stats.textureSwitches);
+            }
+
+            ssvu::lo("Render") << "Level " << l + 1 << ": "
+                               << worst.drawCalls << " draw calls, "
+                               << worst.vertices << " vertices, "
+                               << worst.textureSwitches
+                               << " texture switches (worst frame)\n";
+        }
+
+        ssvu::lo("Render") << "CPU draw time p50/p99/max: "
+                           << drawTimes.getPercentile(0.5f) << "/"
+                           << drawTimes.getPercentile(0.99f) << "/"
+                           << drawTimes.getMax() << "ms, "
+                           << overBudgetFrames << " frames over budget\n";
+
+        level = oldLevel;
+        generated = oldGenerated;
+        setRenderSink(ssvu::mkUPtr<LDWindowSink>(gameWindow));
+        return overBudgetFrames == 0;
+    }
+
+    bool LDGame::testLoopback(LDGame& mGuest, std::size_t mSteps)
+    {
+        auto fail([](const string& mMsg)
+            {
+                ssvu::lo("Loopback") << mMsg << "\n";
+                return false;
+            });
+
+        hostCoop();
+        if(!lockstep.isActive()) return fail("could not host");
+        mGuest.joinCoop();
+        if(!mGuest.lockstep.isActive()) return fail("could not join");
+        if(!spectator.start() || !viewer.connect(sf::IpAddress::LocalHost))
+            return fail("could not start the spectator");
+
+        // Each peer records the hash of every step it simulates
+        std::array<LDGame*, LDLockstep::channelCount> peers{{this, &mGuest}};
+        std::array<std::vector<LDStateHash::Hash>, LDLockstep::channelCount>
+            hashes;
+        sf::Clock clock;
+
+        while(hashes[0].size() < mSteps || hashes[1].size() < mSteps)
+        {
+            if(clock.getElapsedTime() > sf::seconds(60.f))
+                return fail("timed out after " + toStr(hashes[0].size()) +
+                            "/" + toStr(hashes[1].size()) + " steps");
+
+            for(auto i(0u); i < peers.size(); ++i)
+            {
+                auto& p(*peers[i]);
+                if(hashes[i].size() >= mSteps) continue;
+
+                // Scripted inputs, different for each peer
+                const auto frame(p.lockstep.getFrame());
+                p.inputX = static_cast<int>((frame / 40 + i) % 3) - 1;
+                p.inputJump = frame % 50 == i * 25;
+                p.inputAction = (frame / 100) % 2 == 0;
+                p.update(1.f);
+
+                if(p.lockstep.isRunning() && p.lockstep.getFrame() != frame)
+                    hashes[i].push_back(p.stateHash.getTotal());
+            }
+        }
+
+        for(auto i(0u); i < mSteps; ++i)
+            if(hashes[0][i] != hashes[1][i])
+                return fail("desync at step " + toStr(i));
+
+        // The viewer must end up with the session and what the host shows;
+        // the same state is streamed again until it gets through
+        using View = std::vector<std::tuple<int, int, int>>;
+        View expected;
+        auto add([&](int mGroup, LDSpectatorKind mKind)
+            {
+                for(auto& e : manager.getEntities(mGroup))
+                {
+                    const auto& pos(e->getComponent<LDCPhysics>().getPos());
+                    expected.emplace_back(int(mKind),
+                        LDSpectator::quantize(pos.x) * LDSpectator::quantum,
+                        LDSpectator::quantize(pos.y) * LDSpectator::quantum);
+                }
+            });
+        add(LDGroup::Block, LDSpectatorKind::Block);
+        add(LDGroup::Lift, LDSpectatorKind::Lift);
+        add(LDGroup::Player, LDSpectatorKind::Player);
+        add(LDGroup::Receiver, LDSpectatorKind::Receiver);
+        add(LDGroup::Tele, LDSpectatorKind::Tele);
+        sort(begin(expected), end(expected));
+
+        const auto session(getSession());
+        for(clock.restart(); clock.getElapsedTime() < sf::seconds(10.f);)
+        {
+            spectator.capture(manager);
+            viewer.poll();
+            sf::sleep(sf::milliseconds(1));
+
+            const auto& got(viewer.getSession());
+            if(!viewer.hasReceivedSession() || got.level != session.level ||
+                got.generated != session.generated ||
+                got.genSettings.seed != session.genSettings.seed)
+                continue;
+
+            View view;
+            for(const auto& b : viewer.getBodies())
+                view.emplace_back(int(b.second.kind), b.second.position.x,
+                    b.second.position.y);
+            sort(begin(view), end(view));
+            if(view != expected) continue;
+
+            ssvu::lo("Loopback") << mSteps << " steps in sync, "
+                                 << expected.size() << " bodies streamed\n";
+            return true;
+        }
+
+        return fail("spectator view never matched the host");
     }
 }
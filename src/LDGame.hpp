@@ -7,12 +7,27 @@
 
 #include "LDDependencies.hpp"
 #include "LDAssets.hpp"
+#include "LDEvents.hpp"
 #include "LDFactory.hpp"
+#include "LDFramePacer.hpp"
+#include "LDHudText.hpp"
+#include "LDLabelBatch.hpp"
+#include "LDLevelGenerator.hpp"
+#include "LDLevelStream.hpp"
+#include "LDLockstep.hpp"
+#include "LDRenderSink.hpp"
+#include "LDScript.hpp"
+#include "LDSession.hpp"
+#include "LDSolver.hpp"
+#include "LDSpectator.hpp"
+#include "LDStaticIndex.hpp"
+#include "LDStateHash.hpp"
 #include "LDUtils.hpp"
 
 namespace ld
 {
     struct LDMenu;
+    class LDRewind;
 
     struct LDLevelStatus
     {
@@ -30,28 +45,78 @@ namespace ld
         LDFactory factory;
         ssvs::GameState gameState;
         World world;
+        LDStaticIndex staticIndex; // Outlives the manager's entities
         sses::Manager manager;
-        ssvs::BitmapText debugText;
-        ssvu::TimelineManager timelineManager;
+        LDLevelStream stream;
+        LDEventQueue events;
+        LDLabelBatch labels;
+        static constexpr std::size_t debugLineCount{9};
+        std::vector<LDHudText> debugLines; // One topic each, stacked
+        ssvu::UPtr<LDRenderSink> renderSink;
+        LDRenderBudget renderBudget;
+        std::size_t overBudgetFrames{0};
+        LDFramePacer framePacer{1000.f / 200.f}; // Shared with the menu
+        Ticker debugTextTimer{15.f};
+        Ticker activityTimer{5.f};
+        LDScriptManager scripts;
         LDLevelStatus levelStatus;
+        ssvu::UPtr<LDRewind> rewind; // Needs the complete components
+        bool rewinding{false};
+
+        // Per-step state hash, recorded into or verified against a trace
+        enum class HashMode
+        {
+            Off,
+            Recording,
+            Verifying
+        };
+        LDStateHash stateHash;
+        LDHashTrace hashTrace;
+        HashMode hashMode{HashMode::Off};
+
+        // Spectator server, and a loopback viewer to check the stream
+        LDSpectator spectator;
+        LDSpectatorClient viewer;
         LDMenu* menuGame{nullptr};
 
-        ssvs::BitmapText msgText;
+        LDHudText msgText;
         std::string currentMsg;
         Ticker msgCharTimer{2.f}, msgTimer{0.f, false};
 
-        ssvs::BitmapText timerText;
+        LDHudText timerText;
+        float timerTextScale{0.f};
         ssvs::Vec2f panVec;
         bool inputAction{false}, inputJump{false};
         int inputX{0}, inputY{0};
 
+        // Inputs driving each player this step: the keyboard alone, or
+        // both peers' inputs in co-op
+        std::array<LDInput, LDLockstep::channelCount> inputs;
+        LDLockstep lockstep;
+
         bool mustChangeLevel{false};
         int level{0};
 
+        // Staggers time-sliced components; restarts with every level, so
+        // that co-op peers and replays stagger them identically
+        unsigned int slicePhase{0};
+
+        // Players are created there once the level is built
+        ssvs::Vec2i spawn;
+
+        // While set, level builders only describe the level for the
+        // solver: nothing reaches the stream, the factory or the scripts
+        LDLevelData* capturing{nullptr};
+
+        // Content mode: levels come from the generator instead
+        bool generated{false};
+        LDGenSettings genSettings;
+
     public:
         static int levelCount;
 
         LDGame(ssvs::GameWindow& mGameWindow, LDAssets& mAssets);
+        ~LDGame();
 
         void start10Secs();
         void refresh10Secs();
@@ -59,13 +124,21 @@ namespace ld
         void showMessage(const std::string& mMsg, FT mDuration,
             const sf::Color& mColor = sf::Color::White);
 
+        void clearLevel();
+        void loadLevel();
         void newGame();
         void nextLevel();
 
-        sses::Entity& pW(int mX, int mY);
-        sses::Entity& pB(int mX, int mY, int mVal = -1);
-        sses::Entity& pR(int mX, int mY, int mVal = -1);
-        sses::Entity& pT(int mX, int mY);
+        void spawnPlayers();
+
+        void place(LDRecordKind mKind, int mX, int mY, int mVal = -1);
+        void pP(int mX, int mY);
+        void pW(int mX, int mY);
+        void pB(int mX, int mY, int mVal = -1,
+            LDRecordKind mKind = LDRecordKind::Block);
+        void pR(int mX, int mY, int mVal = -1);
+        void pT(int mX, int mY);
+        void pL(const std::vector<ssvs::Vec2i>& mPath, float mSpeed);
 
         void levelOne();
         void levelTwo();
@@ -74,17 +147,93 @@ namespace ld
         void levelFive();
         void levelSix();
         void levelSeven();
+        void levelGenerated();
+
+        // Runs the solver over every built-in level and a few generated
+        // ones, in parallel; results are logged and summarized on screen,
+        // and false is returned if any level failed. Levels are captured
+        // without loading them, so the current game goes on untouched
+        LDLevelData captureLevel();
+        bool checkLevels();
 
         inline void setMenuGame(LDMenu& mMG) { menuGame = &mMG; }
-        inline void setLevel(int mLevel) { level = mLevel; }
+
+        // Restarting, rewinding, the debug tools and level changes from
+        // the menu only affect this peer, and are not part of a hash
+        // trace: they are off in co-op and while a trace is in use
+        inline bool canAlterSimulation() const noexcept
+        {
+            return !lockstep.isActive() && hashMode == HashMode::Off;
+        }
+        inline LDSession getSession() const
+        {
+            return {level, generated, genSettings};
+        }
+        inline void setLevel(int mLevel)
+        {
+            level = mLevel;
+            generated = false;
+        }
+        inline void setGenerated(const LDGenSettings& mSettings)
+        {
+            genSettings = mSettings;
+            generated = true;
+        }
 
         void update(FT mFT);
+        void processEvents();
+        void updateStream();
+        void updateActivity();
+
+        // Points around which the level is loaded and simulated
+        std::array<ssvs::Vec2i, 2> getFocus();
+        ssvs::Vec2i getFocusExtent();
+
+        void updateHash();
+        void toggleHashRecording();
+        void startHashVerifying();
+        void toggleSpectator();
+        void toggleViewer();
+        void hostCoop();
+        void joinCoop();
+        bool updateLockstep();
+        void startSession(sf::Packet& mSession);
+        sses::Entity* getLocalPlayer();
+        bool hasBlocks();
+        void setTimerTextScale(float mScale);
         void updateDebugText(FT mFT);
+        void layoutDebugText();
         void draw();
-        inline void render(const sf::Drawable& mDrawable)
+        void checkRenderBudget();
+
+        // Draws every built-in level for `mFrames` frames into a null sink;
+        // returns false if any frame went over the render budget
+        bool benchmarkRender(std::size_t mFrames);
+
+        // Plays `mSteps` co-op steps over loopback against `mGuest`, with
+        // scripted inputs, and watches them through a loopback spectator;
+        // returns false on a desync, a stall or a wrong spectator view
+        bool testLoopback(LDGame& mGuest, std::size_t mSteps);
+
+        inline void render(const sf::Sprite& mSprite)
+        {
+            renderSink->draw(mSprite, getDrawInfo(mSprite));
+        }
+        template <typename T>
+        inline void render(const T& mDrawable)
         {
-            gameWindow.draw(mDrawable);
+            renderSink->draw(mDrawable, mDrawable.getDrawInfo());
         }
+        inline void setRenderSink(ssvu::UPtr<LDRenderSink> mSink)
+        {
+            renderSink = std::move(mSink);
+        }
+        inline void setRenderBudget(const LDRenderBudget& mBudget)
+        {
+            renderBudget = mBudget;
+        }
+        inline LDRenderSink& getRenderSink() { return *renderSink; }
+        inline LDFramePacer& getFramePacer() { return framePacer; }
 
         inline ssvs::Vec2i getMousePosition() const
         {
@@ -95,12 +244,20 @@ namespace ld
         inline LDFactory& getFactory() { return factory; }
         inline ssvs::GameState& getGameState() { return gameState; }
         inline World& getWorld() { return world; }
+        inline LDStaticIndex& getStaticIndex() { return staticIndex; }
         inline sses::Manager& getManager() { return manager; }
+        inline LDLevelStream& getStream() { return stream; }
+        inline LDEventQueue& getEvents() { return events; }
+        inline LDLabelBatch& getLabels() { return labels; }
+        inline unsigned int getNextSlicePhase() noexcept
+        {
+            return slicePhase++;
+        }
 
-        inline bool getIAction() const { return inputAction; }
-        inline bool getIJump() const { return inputJump; }
-        inline int getIX() const { return inputX; }
-        inline int getIY() const { return inputY; }
+        inline const LDInput& getInput(std::size_t mChannel) const
+        {
+            return inputs[mChannel];
+        }
     };
 }
 
@@ -16,7 +16,10 @@ namespace ld
         CanBePicked,
         Player,
         BlockFloating,
-        GSensor
+        GSensor,
+        Lift, // Entities only: lifts are not blocks to deliver
+        Receiver, // Entities only, for spectators
+        Tele      // Entities only, for spectators
     };
 }
 
@@ -0,0 +1,68 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_HISTOGRAM
+#define SSVLD_HISTOGRAM
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    // Fixed-width buckets of durations in milliseconds; the last bucket
+    // collects everything above the range. Adding never allocates.
+    class LDHistogram
+    {
+    private:
+        std::vector<std::size_t> buckets;
+        float bucketMs;
+        std::size_t count{0};
+        float max{0.f};
+
+    public:
+        inline LDHistogram(std::size_t mBuckets, float mBucketMs)
+            : buckets(mBuckets, 0), bucketMs{mBucketMs}
+        {
+        }
+
+        inline void add(float mMs) noexcept
+        {
+            const auto idx(mMs <= 0.f ? 0 : static_cast<std::size_t>(
+                                                mMs / bucketMs));
+            ++buckets[std::min(idx, buckets.size() - 1)];
+            ++count;
+            max = std::max(max, mMs);
+        }
+        inline void clear() noexcept
+        {
+            std::fill(std::begin(buckets), std::end(buckets), 0);
+            count = 0;
+            max = 0.f;
+        }
+
+        // Upper edge of the bucket holding the `mP` quantile (0 to 1)
+        inline float getPercentile(float mP) const noexcept
+        {
+            if(count == 0) return 0.f;
+
+            const auto rank(static_cast<std::size_t>(mP * (count - 1)));
+            std::size_t seen{0};
+            for(auto i(0u); i < buckets.size() - 1; ++i)
+            {
+                seen += buckets[i];
+                if(seen > rank) return std::min(max, (i + 1) * bucketMs);
+            }
+            return max;
+        }
+
+        inline std::size_t getCount() const noexcept { return count; }
+        inline float getMax() const noexcept { return max; }
+        inline float getBucketMs() const noexcept { return bucketMs; }
+        inline const std::vector<std::size_t>& getBuckets() const noexcept
+        {
+            return buckets;
+        }
+    };
+}
+
+#endif
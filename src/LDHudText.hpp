@@ -0,0 +1,114 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_HUDTEXT
+#define SSVLD_HUDTEXT
+
+#include "LDDependencies.hpp"
+#include "LDRenderSink.hpp"
+
+namespace ld
+{
+    // Retained HUD text: keeps a preallocated string buffer and only
+    // rebuilds the bitmap text glyphs when the displayed contents change.
+    // Formatting goes through a fixed stack buffer, so steady-state
+    // updates never touch the heap. The buffer only fits a few short
+    // lines: longer HUDs are split over several texts.
+    class LDHudText : public sf::Drawable
+    {
+    private:
+        static constexpr std::size_t formatBufferSize{128};
+
+        ssvs::BitmapText text;
+        const ssvs::BitmapFont& font;
+        std::string buffer;
+        std::size_t glyphs{0}; // Quads in the text, whitespace has none
+        sf::Color color{sf::Color::White};
+        bool changed{true};
+
+        inline void commit()
+        {
+            text.setString(buffer);
+            glyphs = 0;
+            for(auto c : buffer)
+                if(c != ' ' && c != '\n') ++glyphs;
+            changed = true;
+        }
+
+    public:
+        inline LDHudText(
+            const ssvs::BitmapFont& mFont, std::size_t mCapacity = 256)
+            : text{mFont}, font(mFont)
+        {
+            buffer.reserve(mCapacity);
+        }
+
+        inline void setString(const std::string& mStr)
+        {
+            if(buffer == mStr) return;
+            buffer.assign(mStr);
+            commit();
+        }
+        // Fixed strings: compared in place, never formatted
+        inline void setString(const char* mStr)
+        {
+            if(buffer == mStr) return;
+            buffer.assign(mStr);
+            commit();
+        }
+
+        // Shows the first `mCount` characters of `mStr` (typewriter effect)
+        inline void setPrefix(const std::string& mStr, std::size_t mCount)
+        {
+            mCount = std::min(mCount, mStr.size());
+            if(buffer.size() == mCount && mStr.compare(0, mCount, buffer) == 0)
+                return;
+            buffer.assign(mStr, 0, mCount);
+            commit();
+        }
+
+        inline void setColor(const sf::Color& mColor)
+        {
+            if(color == mColor) return;
+            color = mColor;
+            text.setColor(color);
+        }
+
+        template <typename... TArgs>
+        inline void format(const char* mFmt, const TArgs&... mArgs)
+        {
+            char formatted[formatBufferSize];
+            std::snprintf(formatted, formatBufferSize, mFmt, mArgs...);
+            if(buffer == formatted) return;
+            buffer.assign(formatted);
+            commit();
+        }
+
+        // Returns true once after every contents change (or `invalidate`
+        // call): callers use it to redo layout that depends on the bounds
+        inline void invalidate() noexcept { changed = true; }
+        inline bool consumeChanged() noexcept
+        {
+            const auto result(changed);
+            changed = false;
+            return result;
+        }
+
+        inline const std::string& getString() const noexcept { return buffer; }
+        inline LDDrawInfo getDrawInfo() const noexcept
+        {
+            return {glyphs * 4, &font.getTexture()};
+        }
+        inline ssvs::BitmapText& getText() noexcept { return text; }
+
+        inline void draw(
+            sf::RenderTarget& mRenderTarget, sf::RenderStates mStates) const
+            override
+        {
+            mRenderTarget.draw(text, mStates);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,38 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_INPUT
+#define SSVLD_INPUT
+
+#include <cstdint>
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    // What drives a player for one step; one per input channel
+    struct LDInput
+    {
+        bool action{false}, jump{false};
+        int x{0}, y{0};
+
+        // Two bits per axis, one per button
+        inline std::uint8_t pack() const noexcept
+        {
+            return (action ? 1 : 0) | (jump ? 2 : 0) | ((x + 1) << 2) |
+                   ((y + 1) << 4);
+        }
+        inline static LDInput unpack(std::uint8_t mBits) noexcept
+        {
+            LDInput result;
+            result.action = (mBits & 1) != 0;
+            result.jump = (mBits & 2) != 0;
+            result.x = ((mBits >> 2) & 3) - 1;
+            result.y = ((mBits >> 4) & 3) - 1;
+            return result;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,96 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_LABELBATCH
+#define SSVLD_LABELBATCH
+
+#include "LDDependencies.hpp"
+#include "LDAtlas.hpp"
+#include "LDRenderSink.hpp"
+
+namespace ld
+{
+    // Draws small integer labels (block stress/values) in a single draw
+    // call. Glyph quads are laid out once per distinct value and cached;
+    // every frame the cached runs are only translated and appended.
+    class LDLabelBatch : public sf::Drawable
+    {
+    private:
+        static constexpr std::size_t maxCachedRuns{1024};
+
+        const ssvs::BitmapFont& font;
+        const sf::Texture& texture;
+        ssvs::Vec2i textureOffset;
+        float scale;
+        int tracking;
+        std::unordered_map<int, std::vector<sf::Vertex>> runs;
+        sf::VertexArray vertices{sf::PrimitiveType::Quads};
+
+        inline const std::vector<sf::Vertex>& getRun(int mValue)
+        {
+            auto itr(runs.find(mValue));
+            if(itr != std::end(runs)) return itr->second;
+
+            if(runs.size() >= maxCachedRuns) runs.clear();
+
+            auto& run(runs[mValue]);
+            float x{0.f};
+            for(const auto& c : ssvu::toStr(mValue))
+            {
+                const auto rect(LDAtlas::getOffsetRect(
+                    font.getGlyphRect(c), textureOffset));
+                const float w{rect.width * scale}, h{rect.height * scale};
+                const float l(rect.left), t(rect.top),
+                    r(rect.left + rect.width), b(rect.top + rect.height);
+
+                run.emplace_back(ssvs::Vec2f{x, 0.f}, ssvs::Vec2f{l, t});
+                run.emplace_back(ssvs::Vec2f{x + w, 0.f}, ssvs::Vec2f{r, t});
+                run.emplace_back(ssvs::Vec2f{x + w, h}, ssvs::Vec2f{r, b});
+                run.emplace_back(ssvs::Vec2f{x, h}, ssvs::Vec2f{l, b});
+
+                x += (rect.width + tracking) * scale;
+            }
+
+            return run;
+        }
+
+    public:
+        // `mTexture` can be an atlas containing the font's texture at
+        // `mTextureOffset`
+        inline LDLabelBatch(const ssvs::BitmapFont& mFont,
+            const sf::Texture& mTexture, const ssvs::Vec2i& mTextureOffset,
+            float mScale, int mTracking)
+            : font(mFont), texture(mTexture), textureOffset{mTextureOffset},
+              scale{mScale}, tracking{mTracking}
+        {
+        }
+
+        inline void add(int mValue, const ssvs::Vec2f& mPosition)
+        {
+            for(auto v : getRun(mValue))
+            {
+                v.position += mPosition;
+                vertices.append(v);
+            }
+        }
+
+        // `sf::VertexArray::clear` keeps its storage around
+        inline void clear() { vertices.clear(); }
+
+        inline LDDrawInfo getDrawInfo() const noexcept
+        {
+            return {vertices.getVertexCount(), &texture};
+        }
+
+        inline void draw(
+            sf::RenderTarget& mRenderTarget, sf::RenderStates mStates) const
+            override
+        {
+            mStates.texture = &texture;
+            mRenderTarget.draw(vertices, mStates);
+        }
+    };
+}
+
+#endif
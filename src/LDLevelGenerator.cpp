@@ -0,0 +1,133 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include "LDGame.hpp"
+#include "LDLevelGenerator.hpp"
+
+using namespace ssvs;
+using namespace std;
+
+namespace ld
+{
+    LDLevelGenerator::LDLevelGenerator(const LDGenSettings& mSettings)
+        : settings(mSettings), rng{mSettings.seed}
+    {
+        settings.columns = std::min(std::max(settings.columns, 8), maxColumns);
+        settings.floors = std::min(std::max(settings.floors, 1), maxFloors);
+        settings.colors = std::max(settings.colors, 1);
+        settings.pileEvery = std::max(settings.pileEvery, 2);
+    }
+
+    void LDLevelGenerator::generateSurfaces()
+    {
+        surfaces.assign(settings.floors, vector<int>(settings.columns, 0));
+        for(auto& s : surfaces)
+        {
+            // Steps of at most one tile: the player can always jump them
+            int offset{0};
+            for(auto& o : s)
+            {
+                if(getRnd(0, 3) == 0)
+                    offset = std::min(std::max(offset + getRnd(-1, 1), 0), 2);
+                o = offset;
+            }
+        }
+
+        shafts.clear();
+        for(int f{0}; f < settings.floors - 1; ++f)
+            shafts.emplace_back(getRnd(3, settings.columns - 4));
+    }
+
+    void LDLevelGenerator::placeFloor(LDGame& mGame, int mFloor)
+    {
+        const int columns{settings.columns};
+        const bool top{mFloor == settings.floors - 1};
+
+        // Columns kept clear of piles and receivers
+        vector<bool> reserved(columns, false);
+        for(int x{0}; x < 3; ++x) reserved[x] = true;
+        if(!top) reserved[shafts[mFloor]] = true;
+        if(mFloor > 0) reserved[shafts[mFloor - 1]] = true;
+        if(top)
+            for(int x{columns - 3}; x < columns; ++x) reserved[x] = true;
+
+        // Block piles
+        vector<int> vals;
+        for(int x{3}; x < columns - 3;
+            x += getRnd(settings.pileEvery / 2, settings.pileEvery * 3 / 2))
+        {
+            if(reserved[x]) continue;
+            reserved[x] = true;
+
+            using K = LDRecordKind;
+            static constexpr K kinds[]{K::Block, K::Block, K::Block,
+                K::Block, K::BlockBig, K::BlockBall, K::BlockRubberH,
+                K::BlockRubberV};
+            const auto kind(kinds[getRnd(0, 7)]);
+            const auto val(getRnd(-1, settings.colors - 1));
+
+            for(int h{getRnd(1, 3)}; h > 0; --h)
+            {
+                mGame.pB(x, getSurface(mFloor, x) - h, val, kind);
+                ++tileCount;
+            }
+
+            if(find(begin(vals), end(vals), val) == end(vals))
+                vals.emplace_back(val);
+        }
+
+        // One receiver per value found on this floor, sunk in the ground
+        vector<int> receivers(columns, -2);
+        for(auto v : vals)
+            for(int attempts{0}; attempts < columns; ++attempts)
+            {
+                const auto x(getRnd(3, columns - 4));
+                if(reserved[x]) continue;
+                reserved[x] = true;
+                receivers[x] = v;
+                break;
+            }
+
+        // Wall runs, with the lift shaft from the floor below left open
+        for(int x{0}; x < columns; ++x)
+        {
+            if(mFloor > 0 && x == shafts[mFloor - 1]) continue;
+
+            int y{getSurface(mFloor, x)};
+            if(receivers[x] != -2) mGame.pR(x, y++, receivers[x]);
+
+            for(; y <= getBase(mFloor) + 1; ++y) mGame.pW(x, y);
+            tileCount += getBase(mFloor) + 2 - getSurface(mFloor, x);
+        }
+
+        for(int y{getBase(mFloor) - floorHeight + 2};
+            y <= getBase(mFloor) + 1; ++y)
+        {
+            mGame.pW(-1, y);
+            mGame.pW(columns, y);
+            tileCount += 2;
+        }
+
+        if(!top)
+        {
+            const auto x(shafts[mFloor]);
+            mGame.pL({{x, getSurface(mFloor, x) - 1},
+                         {x, getSurface(mFloor + 1, x) - 1}},
+                200.f);
+        }
+        else
+        {
+            mGame.pT(columns - 2, getSurface(mFloor, columns - 2) - 1);
+            ++tileCount;
+        }
+    }
+
+    void LDLevelGenerator::generate(LDGame& mGame)
+    {
+        tileCount = 0;
+        generateSurfaces();
+        for(int f{0}; f < settings.floors; ++f) placeFloor(mGame, f);
+        spawn = {1, getSurface(0, 1) - 1};
+    }
+}
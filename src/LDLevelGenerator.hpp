@@ -0,0 +1,75 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_LEVELGENERATOR
+#define SSVLD_LEVELGENERATOR
+
+#include <random>
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    class LDGame;
+
+    struct LDGenSettings
+    {
+        unsigned int seed{0};
+        int columns{64}; // Tiles per floor
+        int floors{2};
+        int colors{3};  // Distinct block values, excluding grey blocks
+        int pileEvery{10}; // Average columns between two block piles
+    };
+
+    // Builds a level from a seed: a tower of floors made of uneven wall
+    // runs, joined by lift shafts. Every floor gets block piles and a
+    // receiver for each block value it contains, so it can be cleared on
+    // its own; the teleporter is at the end of the top floor.
+    // The same settings always give the same level.
+    class LDLevelGenerator
+    {
+    public:
+        static constexpr int floorHeight{11};
+
+        // The world's hash grid does not extend past this many tiles from
+        // the level origin, in either direction
+        static constexpr int maxColumns{440};
+        static constexpr int maxFloors{440 / floorHeight};
+
+    private:
+        LDGenSettings settings;
+        std::mt19937 rng;
+        std::vector<std::vector<int>> surfaces; // Ground offsets per floor
+        std::vector<int> shafts;                // Lift column per floor
+        ssvs::Vec2i spawn;
+        std::size_t tileCount{0};
+
+        inline int getRnd(int mMin, int mMax)
+        {
+            return std::uniform_int_distribution<int>{mMin, mMax}(rng);
+        }
+        inline int getBase(int mFloor) const noexcept
+        {
+            return -mFloor * floorHeight;
+        }
+        inline int getSurface(int mFloor, int mX) const noexcept
+        {
+            return getBase(mFloor) - surfaces[mFloor][mX];
+        }
+
+        void generateSurfaces();
+        void placeFloor(LDGame& mGame, int mFloor);
+
+    public:
+        LDLevelGenerator(const LDGenSettings& mSettings);
+
+        // Places the whole level (except the player) through `mGame`
+        void generate(LDGame& mGame);
+
+        inline const ssvs::Vec2i& getSpawn() const noexcept { return spawn; }
+        inline std::size_t getTileCount() const noexcept { return tileCount; }
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include "LDGame.hpp"
+#include "LDLevelStream.hpp"
+#include "LDCPhysics.hpp"
+#include "LDCPlayer.hpp"
+
+using namespace ssvs;
+using namespace sses;
+using namespace std;
+
+namespace ld
+{
+    Entity& LDLevelStream::create(const LDRecord& mRecord)
+    {
+        using K = LDRecordKind;
+        const auto& p(mRecord.position);
+        const auto v(mRecord.val);
+
+        switch(mRecord.kind)
+        {
+            case K::Wall: return factory.createWall(p);
+            case K::Block: return factory.createBlock(p, v);
+            case K::BlockBig: return factory.createBlockBig(p, v);
+            case K::BlockBall: return factory.createBlockBall(p, v);
+            case K::BlockRubberH: return factory.createBlockRubberH(p, v);
+            case K::BlockRubberV: return factory.createBlockRubberV(p, v);
+            case K::Receiver: return factory.createReceiver(p, v);
+            case K::Tele: break;
+        }
+
+        return factory.createTele(p);
+    }
+
+    void LDLevelStream::store(const LDRecord& mRecord)
+    {
+        chunks[getKey(mRecord.position)].records.emplace_back(mRecord);
+        if(isBlock(mRecord.kind)) ++storedBlocks;
+    }
+
+    void LDLevelStream::load(std::uint64_t mKey, Chunk& mChunk)
+    {
+        mChunk.loaded = true;
+        loaded.emplace_back(mKey);
+
+        for(const auto& r : mChunk.records)
+        {
+            auto& entity(create(r));
+            if(isBlock(r.kind))
+            {
+                --storedBlocks;
+                entity.getComponent<LDCPhysics>().getBody().setVelocity(
+                    r.velocity);
+            }
+            mChunk.owned.push_back({&entity, entity.getStat(), r});
+        }
+
+        mChunk.records.clear();
+    }
+
+    void LDLevelStream::unload(Chunk& mChunk)
+    {
+        mChunk.loaded = false;
+
+        // Taken out first: entities may be handed back to this same chunk
+        auto owned(std::move(mChunk.owned));
+        mChunk.owned.clear();
+
+        for(auto& o : owned)
+        {
+            // Destroyed entities (received or crushed blocks) stay gone;
+            // the stat only expires once the manager refreshes, so those
+            // destroyed during this step are told apart by their flag
+            if(!manager.isAlive(o.stat) || !o.entity->isAlive()) continue;
+
+            auto& cPhysics(o.entity->getComponent<LDCPhysics>());
+            auto& target(chunks[getKey(cPhysics.getPos())]);
+
+            if(target.loaded)
+            {
+                target.owned.emplace_back(o);
+                continue;
+            }
+
+            if(isBlock(o.record.kind))
+            {
+                o.record.position = cPhysics.getPos();
+                o.record.velocity = cPhysics.getVelocity();
+                o.record.val = o.entity->getComponent<LDCBlock>().getVal();
+            }
+
+            o.entity->destroy();
+            store(o.record);
+        }
+    }
+}
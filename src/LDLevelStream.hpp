@@ -0,0 +1,192 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_LEVELSTREAM
+#define SSVLD_LEVELSTREAM
+
+#include <cstdint>
+
+#include "LDDependencies.hpp"
+#include "LDUtils.hpp"
+
+namespace ld
+{
+    class LDFactory;
+
+    enum class LDRecordKind
+    {
+        Wall,
+        Block,
+        BlockBig,
+        BlockBall,
+        BlockRubberH,
+        BlockRubberV,
+        Receiver,
+        Tele
+    };
+
+    // Serialized entity: enough to recreate it through the factory
+    struct LDRecord
+    {
+        LDRecordKind kind;
+        ssvs::Vec2i position;
+        ssvs::Vec2f velocity;
+        int val;
+    };
+
+    // Splits a level into square chunks of records. Only the chunks around
+    // the focus points are instantiated in the manager and the world; when
+    // a chunk falls out of range, its surviving entities are serialized
+    // back into records (with their current position and velocity) and
+    // destroyed. Entities that moved into a still-loaded chunk are handed
+    // over to it instead.
+    class LDLevelStream
+    {
+    public:
+        static constexpr int chunkSize{3200 * 8};
+
+    private:
+        struct Owned
+        {
+            sses::Entity* entity;
+            sses::EntityStat stat;
+            LDRecord record;
+        };
+
+        struct Chunk
+        {
+            std::vector<LDRecord> records;
+            std::vector<Owned> owned;
+            bool loaded{false};
+        };
+
+        LDFactory& factory;
+        sses::Manager& manager;
+        std::unordered_map<std::uint64_t, Chunk> chunks;
+        std::vector<std::uint64_t> loaded;
+        std::size_t storedBlocks{0};
+
+        inline static int getChunkCoord(int mValue) noexcept
+        {
+            return getCellCoord(mValue, chunkSize);
+        }
+        inline static std::uint64_t getKey(const ssvs::Vec2i& mPos) noexcept
+        {
+            return getCellKey(getChunkCoord(mPos.x), getChunkCoord(mPos.y));
+        }
+        inline static bool isBlock(LDRecordKind mKind) noexcept
+        {
+            return mKind != LDRecordKind::Wall &&
+                   mKind != LDRecordKind::Receiver &&
+                   mKind != LDRecordKind::Tele;
+        }
+
+        sses::Entity& create(const LDRecord& mRecord);
+        void load(std::uint64_t mKey, Chunk& mChunk);
+        void unload(Chunk& mChunk);
+        void store(const LDRecord& mRecord);
+
+    public:
+        inline LDLevelStream(LDFactory& mFactory, sses::Manager& mManager)
+            : factory(mFactory), manager(mManager)
+        {
+        }
+
+        inline void add(
+            LDRecordKind mKind, const ssvs::Vec2i& mPosition, int mVal = -1)
+        {
+            store({mKind, mPosition, ssvs::zeroVec2f, mVal});
+        }
+
+        // Loads every chunk within `mLoadExtent` of a focus point and
+        // unloads the loaded ones beyond `mLoadExtent` plus one chunk
+        template <std::size_t TN>
+        void update(const std::array<ssvs::Vec2i, TN>& mFocus,
+            const ssvs::Vec2i& mLoadExtent);
+
+        // Drops every chunk and record; entities are left to the manager
+        inline void clear()
+        {
+            chunks.clear();
+            loaded.clear();
+            storedBlocks = 0;
+        }
+
+        // Appends the records of every unloaded chunk: before the first
+        // `update`, that is the whole level
+        inline void getRecords(std::vector<LDRecord>& mOut) const
+        {
+            for(const auto& c : chunks)
+                mOut.insert(std::end(mOut), std::begin(c.second.records),
+                    std::end(c.second.records));
+        }
+
+        // Blocks waiting in unloaded chunks still count as level contents
+        inline bool hasStoredBlocks() const noexcept
+        {
+            return storedBlocks > 0;
+        }
+        inline std::size_t getLoadedCount() const noexcept
+        {
+            return loaded.size();
+        }
+        inline std::size_t getChunkCount() const noexcept
+        {
+            return chunks.size();
+        }
+    };
+
+    template <std::size_t TN>
+    inline void LDLevelStream::update(const std::array<ssvs::Vec2i, TN>& mFocus,
+        const ssvs::Vec2i& mLoadExtent)
+    {
+        const ssvs::Vec2i keepExtent{
+            mLoadExtent.x + chunkSize, mLoadExtent.y + chunkSize};
+
+        // Unload first: records handed over to unloaded neighbours may
+        // then be loaded again right away if they are in range
+        for(auto i(0u); i < loaded.size();)
+        {
+            const auto origin(getCellCoords(loaded[i]) * chunkSize);
+            bool keep{false};
+            for(const auto& f : mFocus)
+                keep = keep ||
+                       (origin.x + chunkSize > f.x - keepExtent.x &&
+                           origin.x < f.x + keepExtent.x &&
+                           origin.y + chunkSize > f.y - keepExtent.y &&
+                           origin.y < f.y + keepExtent.y);
+
+            if(keep)
+            {
+                ++i;
+                continue;
+            }
+
+            auto& chunk(chunks[loaded[i]]);
+            loaded[i] = loaded.back();
+            loaded.pop_back();
+            unload(chunk);
+        }
+
+        for(const auto& f : mFocus)
+        {
+            const int x0{getChunkCoord(f.x - mLoadExtent.x)},
+                x1{getChunkCoord(f.x + mLoadExtent.x)},
+                y0{getChunkCoord(f.y - mLoadExtent.y)},
+                y1{getChunkCoord(f.y + mLoadExtent.y)};
+
+            for(int y{y0}; y <= y1; ++y)
+                for(int x{x0}; x <= x1; ++x)
+                {
+                    const auto key(getCellKey(x, y));
+                    auto itr(chunks.find(key));
+                    if(itr == std::end(chunks) || itr->second.loaded)
+                        continue;
+                    load(key, itr->second);
+                }
+        }
+    }
+}
+
+#endif
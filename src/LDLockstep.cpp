@@ -0,0 +1,160 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include "LDLockstep.hpp"
+
+using namespace std;
+
+namespace ld
+{
+    bool LDLockstep::host(const sf::Packet& mSession, unsigned short mPort)
+    {
+        stop();
+        if(listener.listen(mPort) != sf::Socket::Done) return false;
+
+        listener.setBlocking(false);
+        session = mSession;
+        local = 0;
+        status = Status::Hosting;
+        return true;
+    }
+    bool LDLockstep::join(const sf::IpAddress& mAddress, unsigned short mPort)
+    {
+        stop();
+        socket.setBlocking(true);
+        if(socket.connect(mAddress, mPort, sf::seconds(1.f)) !=
+            sf::Socket::Done)
+            return false;
+
+        socket.setBlocking(false);
+        local = 1;
+        status = Status::Joining;
+        return true;
+    }
+    void LDLockstep::stop()
+    {
+        listener.close();
+        socket.disconnect();
+        outbox.clear();
+        local = 0;
+        status = Status::Off;
+    }
+
+    void LDLockstep::begin()
+    {
+        frame = 0;
+        stalls = 0;
+        stalled = false;
+        latency.clear();
+        remote.fill(0);
+
+        // The first frames have no input yet on either side
+        const auto now(clock.getElapsedTime().asMicroseconds());
+        for(auto f(0u); f < inputDelay; ++f)
+        {
+            inputs[f] = {};
+            remote[f] = f + 1;
+            sampledAt[f] = now;
+        }
+
+        status = Status::Running;
+    }
+
+    bool LDLockstep::flush()
+    {
+        while(!outbox.empty())
+        {
+            const auto result(socket.send(outbox.front()));
+            if(result == sf::Socket::Partial || result == sf::Socket::NotReady)
+                return true;
+
+            if(result != sf::Socket::Done) return false;
+            outbox.pop_front();
+        }
+
+        return true;
+    }
+
+    LDLockstep::Event LDLockstep::poll()
+    {
+        if(status == Status::Hosting)
+        {
+            if(listener.accept(socket) != sf::Socket::Done)
+                return Event::None;
+
+            listener.close();
+            socket.setBlocking(false);
+            outbox.push_back(session);
+            flush();
+            begin();
+            return Event::Started;
+        }
+
+        if(!flush())
+        {
+            stop();
+            return Event::Lost;
+        }
+
+        sf::Packet packet;
+        while(status == Status::Joining || status == Status::Running)
+        {
+            const auto result(socket.receive(packet));
+            if(result == sf::Socket::NotReady || result == sf::Socket::Partial)
+                return Event::None;
+
+            if(result != sf::Socket::Done)
+            {
+                stop();
+                return Event::Lost;
+            }
+
+            // The first packet the guest gets is the session
+            if(status == Status::Joining)
+            {
+                session = packet;
+                begin();
+                return Event::Started;
+            }
+
+            sf::Uint32 f;
+            sf::Uint8 bits;
+            if(!(packet >> f >> bits)) continue;
+
+            const auto idx(f % bufferSize);
+            inputs[idx][1 - local] = LDInput::unpack(bits);
+            remote[idx] = f + 1;
+        }
+
+        return Event::None;
+    }
+
+    bool LDLockstep::advance(
+        const LDInput& mLocal, array<LDInput, channelCount>& mOut)
+    {
+        const auto idx(frame % bufferSize);
+        if(remote[idx] != frame + 1)
+        {
+            if(!stalled) ++stalls;
+            stalled = true;
+            return false;
+        }
+        stalled = false;
+
+        const auto now(clock.getElapsedTime().asMicroseconds());
+        const auto target(frame + inputDelay), targetIdx(target % bufferSize);
+        inputs[targetIdx][local] = mLocal;
+        sampledAt[targetIdx] = now;
+
+        // A broken connection is reported by the next poll
+        outbox.emplace_back();
+        outbox.back() << sf::Uint32(target) << sf::Uint8(mLocal.pack());
+        flush();
+
+        mOut = inputs[idx];
+        latency.add((now - sampledAt[idx]) / 1000.f);
+        ++frame;
+        return true;
+    }
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_LOCKSTEP
+#define SSVLD_LOCKSTEP
+
+#include <cstdint>
+#include <deque>
+
+#include "LDDependencies.hpp"
+#include "LDHistogram.hpp"
+#include "LDInput.hpp"
+
+namespace ld
+{
+    // Two-player lockstep over TCP: only input frames go on the wire, as
+    // { u32 frame, u8 input }. The input sampled at frame `f` is used at
+    // frame `f + inputDelay` on both sides; a step is only simulated once
+    // both inputs for it are known, so nothing is ever resimulated. The
+    // host is channel 0 and also sends the session (level) to the guest.
+    class LDLockstep
+    {
+    public:
+        static constexpr unsigned short defaultPort{27028};
+        static constexpr std::uint32_t inputDelay{1};
+        static constexpr std::size_t channelCount{2};
+
+        enum class Event
+        {
+            None,
+            Started, // Both sides must load the session's level now
+            Lost
+        };
+
+    private:
+        static constexpr std::size_t bufferSize{64};
+
+        enum class Status
+        {
+            Off,
+            Hosting,  // Waiting for the guest
+            Joining,  // Waiting for the session
+            Running
+        };
+
+        sf::TcpListener listener;
+        sf::TcpSocket socket;
+        sf::Packet session;
+        Status status{Status::Off};
+
+        // Packets the non-blocking socket could not take yet, oldest first;
+        // retried on every poll and advance
+        std::deque<sf::Packet> outbox;
+        std::size_t local{0};
+        std::uint32_t frame{0};
+
+        // Indexed by frame; `remote` holds frame + 1 once it arrived
+        std::array<std::array<LDInput, channelCount>, bufferSize> inputs;
+        std::array<std::uint32_t, bufferSize> remote;
+        std::array<sf::Int64, bufferSize> sampledAt;
+
+        sf::Clock clock;
+        LDHistogram latency{64, 1.f};
+        std::size_t stalls{0};
+        bool stalled{false};
+
+        void begin();
+
+        // Sends as much of the outbox as the socket takes; returns false
+        // if the connection is gone
+        bool flush();
+
+    public:
+        bool host(const sf::Packet& mSession,
+            unsigned short mPort = defaultPort);
+        bool join(const sf::IpAddress& mAddress,
+            unsigned short mPort = defaultPort);
+        void stop();
+
+        // Accepts the guest, sends queued packets, receives the session and
+        // remote inputs
+        Event poll();
+
+        // Simulates the current frame if both inputs are known: schedules
+        // and queues `mLocal` for sending, fills `mOut` with the frame's
+        // inputs. Returns false (a stall) otherwise
+        bool advance(const LDInput& mLocal,
+            std::array<LDInput, channelCount>& mOut);
+
+        inline bool isActive() const noexcept { return status != Status::Off; }
+        inline bool isRunning() const noexcept
+        {
+            return status == Status::Running;
+        }
+        inline std::size_t getLocalChannel() const noexcept { return local; }
+        inline std::uint32_t getFrame() const noexcept { return frame; }
+        inline sf::Packet& getSession() noexcept { return session; }
+
+        // Time from sampling an input to simulating the frame that uses it
+        inline const LDHistogram& getLatency() const noexcept
+        {
+            return latency;
+        }
+        inline std::size_t getStalls() const noexcept { return stalls; }
+    };
+}
+
+#endif
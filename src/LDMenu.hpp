@@ -20,8 +20,22 @@ namespace ld
         LDGame& game;
         ssvms::Menu menu;
         ssvs::BitmapText txt, creditsTxt;
+
+        // One retained text per menu item: glyphs are only rebuilt when the
+        // item's label or selection state changes
+        std::vector<ssvs::BitmapText> itemTxts;
+        std::vector<std::string> itemStrs;
         ssvs::Camera camera{window, 2.f};
-        int level{0};
+        int level{0}, genSize{1};
+
+        // The menu is drawn into `cache` only after input; other frames
+        // just blit it. With no input for a while, frames are paced at
+        // `idleMs` by sleeping only
+        static constexpr float activeMs{1000.f / 200.f}, idleMs{50.f};
+        sf::RenderTexture cache;
+        sf::Sprite cacheSprite;
+        bool dirty{true}, idle{false};
+        Ticker idleTimer{60.f};
 
         LDMenu(ssvs::GameWindow& mGameWindow, LDAssets& mAssets, LDGame& mGame)
             : window(mGameWindow), assets(mAssets), game(mGame),
@@ -42,6 +56,9 @@ namespace ld
                 {window.getWidth() - creditsTxt.getGlobalBounds().width,
                     window.getHeight() - creditsTxt.getGlobalBounds().height});
 
+            cache.create(window.getWidth(), window.getHeight());
+            cacheSprite.setTexture(cache.getTexture());
+
             gameState.onUpdate += [this](FT mFT)
             {
                 update(mFT);
@@ -49,6 +66,7 @@ namespace ld
             gameState.onDraw += [this]
             {
                 draw();
+                game.getFramePacer().pace();
             };
 
             using k = ssvs::KKey;
@@ -57,45 +75,55 @@ namespace ld
             gameState.addInput({{k::Up}},
                 [this](FT)
                 {
-                    assets.playSound("blip.wav");
+                    wake();
+                    assets.playSound(LDSound::Blip);
                     menu.previous();
                 },
                 t::Once);
             gameState.addInput({{k::Down}},
                 [this](FT)
                 {
-                    assets.playSound("blip.wav");
+                    wake();
+                    assets.playSound(LDSound::Blip);
                     menu.next();
                 },
                 t::Once);
             gameState.addInput({{k::Left}},
                 [this](FT)
                 {
-                    assets.playSound("blip.wav");
+                    wake();
+                    assets.playSound(LDSound::Blip);
                     menu.decrease();
                 },
                 t::Once);
             gameState.addInput({{k::Right}},
                 [this](FT)
                 {
-                    assets.playSound("blip.wav");
+                    wake();
+                    assets.playSound(LDSound::Blip);
                     menu.increase();
                 },
                 t::Once);
             gameState.addInput({{k::Return}, {k::Space}},
                 [this](FT)
                 {
-                    assets.playSound("blip.wav");
+                    wake();
+                    assets.playSound(LDSound::Blip);
                     menu.exec();
                 },
                 t::Once);
 
             namespace i = ssvms::Items;
             auto& main = menu.createCategory("10corp");
+            // A co-op session, on both peers, or a recorded or verified hash
+            // trace keeps its level: playing only resumes it
             main.create<i::Single>("play", [this]
                 {
-                    game.setLevel(level);
-                    game.newGame();
+                    if(game.canAlterSimulation())
+                    {
+                        game.setLevel(level);
+                        game.newGame();
+                    }
                     window.setGameState(game.getGameState());
                     assets.playMusic("mus.ogg");
                 });
@@ -110,15 +138,41 @@ namespace ld
                 },
                 0, LDGame::levelCount, 1);
 
+            main.create<i::Single>("play generated", [this]
+                {
+                    // Size 10 is the largest level the world can hold
+                    if(game.canAlterSimulation())
+                    {
+                        LDGenSettings settings;
+                        settings.seed = ssvu::getRndI(0, 100000);
+                        settings.columns = 44 * genSize;
+                        settings.floors = 4 * genSize;
+                        game.setGenerated(settings);
+                        game.newGame();
+                    }
+                    window.setGameState(game.getGameState());
+                    assets.playMusic("mus.ogg");
+                });
+            main.create<i::Slider>("generated size",
+                [this]
+                {
+                    return genSize;
+                },
+                [this](int s)
+                {
+                    genSize = s;
+                },
+                1, 10, 1);
+
             main.create<i::Toggle>("sound", LDConfig::get().soundEnabled);
             main.create<i::Slider>("sound volume",
                 [this]
                 {
-                    return assets.soundPlayer.getVolume();
+                    return assets.getSoundVolume();
                 },
                 [this](int v)
                 {
-                    assets.soundPlayer.setVolume(v);
+                    assets.setSoundVolume(v);
                 },
                 0, 100, 10) |
                 [this]
@@ -129,11 +183,11 @@ namespace ld
             main.create<i::Slider>("music volume",
                 [this]
                 {
-                    return assets.musicPlayer.getVolume();
+                    return assets.getMusicVolume();
                 },
                 [this](int v)
                 {
-                    assets.musicPlayer.setVolume(v);
+                    assets.setMusicVolume(v);
                 },
                 0, 100, 10) |
                 [this]
@@ -147,20 +201,44 @@ namespace ld
                 });
         }
 
+        inline void wake()
+        {
+            dirty = true;
+            idleTimer.restart();
+            if(!idle) return;
+
+            idle = false;
+            game.getFramePacer().setTargetMs(activeMs);
+            game.getFramePacer().setSleepOnly(false);
+        }
+
         inline void update(FT mFT)
         {
             camera.update(mFT);
             menu.update();
+
+            if(idle || !idleTimer.update(mFT)) return;
+            idle = true;
+            game.getFramePacer().setTargetMs(idleMs);
+            game.getFramePacer().setSleepOnly(true);
         }
         inline void draw()
         {
-            camera.apply();
-            drawMenu(menu);
-            camera.unapply();
-            render(creditsTxt);
+            if(dirty)
+            {
+                dirty = false;
+                cache.clear(sf::Color::Transparent);
+                cache.setView(camera.getView());
+                drawMenu(menu);
+                cache.setView(cache.getDefaultView());
+                render(creditsTxt);
+                cache.display();
+            }
+
+            window.draw(cacheSprite);
         }
 
-        inline void render(sf::Drawable& mDrawable) { window.draw(mDrawable); }
+        inline void render(sf::Drawable& mDrawable) { cache.draw(mDrawable); }
         inline ssvs::BitmapText& renderTextImpl(const std::string& mStr,
             ssvs::BitmapText& mText, const ssvs::Vec2f& mPosition)
         {
@@ -187,6 +265,34 @@ namespace ld
             return renderTextImpl(mStr, mText, mPos);
         }
 
+        inline static bool isItemStr(const std::string& mStr,
+            bool mSelected, const std::string& mName)
+        {
+            const std::size_t prefixSize{mSelected ? 3u : 0u};
+            return mStr.size() == prefixSize + mName.size() &&
+                   (!mSelected || mStr.compare(0, prefixSize, ">> ") == 0) &&
+                   mStr.compare(prefixSize, mName.size(), mName) == 0;
+        }
+        inline std::string& getItemStr(int mIdx, bool mSelected,
+            const std::string& mName)
+        {
+            while(ssvu::toInt(itemStrs.size()) <= mIdx)
+            {
+                itemTxts.emplace_back(
+                    assets.get<ssvs::BitmapFont>("limeStroked"));
+                itemTxts.back().setTracking(-3);
+                itemStrs.emplace_back();
+            }
+
+            auto& str(itemStrs[mIdx]);
+            if(isItemStr(str, mSelected, mName)) return str;
+
+            str.clear();
+            if(mSelected) str.append(">> ");
+            str.append(mName);
+            return str;
+        }
+
         void drawMenu(const ssvms::Menu& mMenu)
         {
             renderText(mMenu.getCategory().getName(), txt, ssvs::zeroVec2f);
@@ -201,13 +307,13 @@ namespace ld
                     currentY = 0;
                     currentX += 180;
                 }
-                std::string name, itemName{currentItems[i]->getName()};
-                if(i == mMenu.getIdx()) name.append(">> ");
-                name.append(itemName);
+                const auto& itemName(currentItems[i]->getName());
+                const auto& name(
+                    getItemStr(i, i == mMenu.getIdx(), itemName));
 
                 int extraSpacing{0};
                 if(itemName == "back") extraSpacing = 20;
-                renderText(name, txt,
+                renderText(name, itemTxts[i],
                     {20.f + currentX, 20.f + currentY + extraSpacing},
                     currentItems[i]->isEnabled()
                         ? sf::Color::White
@@ -0,0 +1,154 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_RENDERSINK
+#define SSVLD_RENDERSINK
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    // What a drawable costs: vertices submitted and the texture bound
+    struct LDDrawInfo
+    {
+        std::size_t vertices;
+        const void* texture;
+    };
+
+    inline LDDrawInfo getDrawInfo(const sf::Sprite& mSprite) noexcept
+    {
+        return {4, mSprite.getTexture()};
+    }
+
+    struct LDRenderStats
+    {
+        std::size_t drawCalls{0}, vertices{0}, textureSwitches{0};
+    };
+
+    struct LDRenderBudget
+    {
+        std::size_t drawCalls{5000}, vertices{40000}, textureSwitches{16};
+
+        inline bool isExceeded(const LDRenderStats& mStats) const noexcept
+        {
+            return mStats.drawCalls > drawCalls ||
+                   mStats.vertices > vertices ||
+                   mStats.textureSwitches > textureSwitches;
+        }
+    };
+
+    // Destination of every `LDGame::render` call. All sinks count draw
+    // calls, vertices and texture switches; the null sink does nothing
+    // else, so the whole CPU side of drawing can run without a GPU.
+    class LDRenderSink
+    {
+    private:
+        LDRenderStats stats, lastFrame;
+        const void* lastTexture{nullptr};
+
+    protected:
+        virtual void drawImpl(const sf::Drawable& mDrawable) = 0;
+
+        // Frame boundaries, for sinks that own their target
+        virtual void beginFrameImpl() {}
+        virtual void endFrameImpl() {}
+
+    public:
+        virtual ~LDRenderSink() {}
+
+        inline void beginFrame() { beginFrameImpl(); }
+
+        inline void draw(const sf::Drawable& mDrawable, const LDDrawInfo& mInfo)
+        {
+            ++stats.drawCalls;
+            stats.vertices += mInfo.vertices;
+            if(mInfo.texture != lastTexture)
+            {
+                ++stats.textureSwitches;
+                lastTexture = mInfo.texture;
+            }
+
+            drawImpl(mDrawable);
+        }
+
+        // Called once the frame is drawn; its stats become `getLastFrame`
+        inline void endFrame()
+        {
+            lastFrame = stats;
+            stats = {};
+            lastTexture = nullptr;
+            endFrameImpl();
+        }
+        inline const LDRenderStats& getLastFrame() const noexcept
+        {
+            return lastFrame;
+        }
+    };
+
+    class LDWindowSink : public LDRenderSink
+    {
+    private:
+        ssvs::GameWindow& gameWindow;
+
+    protected:
+        inline void drawImpl(const sf::Drawable& mDrawable) override
+        {
+            gameWindow.draw(mDrawable);
+        }
+
+    public:
+        inline LDWindowSink(ssvs::GameWindow& mGameWindow)
+            : gameWindow(mGameWindow)
+        {
+        }
+    };
+
+    // Draws offscreen, with the view the camera set on the window. Each
+    // finished frame is then shown on the window as a single sprite, and
+    // stays available through `getTexture` until the next one begins
+    class LDTextureSink : public LDRenderSink
+    {
+    private:
+        ssvs::GameWindow& gameWindow;
+        sf::RenderTexture texture;
+
+    protected:
+        inline void drawImpl(const sf::Drawable& mDrawable) override
+        {
+            texture.setView(gameWindow.getRenderWindow().getView());
+            texture.draw(mDrawable);
+        }
+        inline void beginFrameImpl() override { texture.clear(); }
+        inline void endFrameImpl() override
+        {
+            texture.display();
+
+            auto& window(gameWindow.getRenderWindow());
+            const auto view(window.getView());
+            window.setView(window.getDefaultView());
+            window.draw(sf::Sprite{texture.getTexture()});
+            window.setView(view);
+        }
+
+    public:
+        inline LDTextureSink(ssvs::GameWindow& mGameWindow)
+            : gameWindow(mGameWindow)
+        {
+            texture.create(gameWindow.getWidth(), gameWindow.getHeight());
+        }
+
+        inline const sf::Texture& getTexture() const
+        {
+            return texture.getTexture();
+        }
+    };
+
+    class LDNullSink : public LDRenderSink
+    {
+    protected:
+        inline void drawImpl(const sf::Drawable&) override {}
+    };
+}
+
+#endif
@@ -0,0 +1,146 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include "LDGame.hpp"
+#include "LDRewind.hpp"
+
+using namespace ssvs;
+using namespace sses;
+using namespace std;
+
+namespace ld
+{
+    namespace
+    {
+        inline bool hasMoved(const Body& mBody)
+        {
+            return mBody.getVelocity() != zeroVec2f ||
+                   mBody.getShape().getX() != mBody.getOldShape().getX() ||
+                   mBody.getShape().getY() != mBody.getOldShape().getY();
+        }
+    }
+
+    void LDRewind::capture(Manager& mManager, const Ticker& mTimer,
+        bool mStarted)
+    {
+        auto& frame(frames[head % frameCount]);
+        frame.index = head;
+        frame.key = sinceKey >= keyInterval;
+        frame.first = written;
+        frame.timer = mTimer;
+        frame.started = mStarted;
+        frame.hasPlayer = false;
+
+        for(auto& e : mManager.getEntities(LDGroup::Block))
+        {
+            auto& cPhysics(e->getComponent<LDCPhysics>());
+            auto& cBlock(e->getComponent<LDCBlock>());
+            if(!frame.key && cPhysics.isRecorded() && !cBlock.hasParent() &&
+                !hasMoved(cPhysics.getBody()))
+                continue;
+
+            push(*e, cPhysics, &cBlock);
+        }
+
+        // Riders must find lifts where they were: their path state is not
+        // kept, a restored lift heads on to its current waypoint
+        for(auto& e : mManager.getEntities(LDGroup::Lift))
+        {
+            auto& cPhysics(e->getComponent<LDCPhysics>());
+            if(frame.key || !cPhysics.isRecorded() ||
+                hasMoved(cPhysics.getBody()))
+                push(*e, cPhysics, nullptr);
+        }
+
+        if(mManager.hasEntity(LDGroup::Player))
+        {
+            auto& e(*mManager.getEntities(LDGroup::Player)[0]);
+            push(e, e.getComponent<LDCPhysics>(), nullptr);
+            frame.hasPlayer = true;
+            frame.player = e.getComponent<LDCPlayer>().getState();
+        }
+
+        frame.count = written - frame.first;
+        frame.valid = true;
+        if(written > poolSize) oldest = std::max(oldest, written - poolSize);
+        sinceKey = frame.key ? 1 : sinceKey + 1;
+        ++head;
+    }
+
+    bool LDRewind::restore(Manager& mManager, Ticker& mTimer, bool& mStarted,
+        size_t mSteps)
+    {
+        if(head == 0) return false;
+
+        auto isUsable([this](size_t mIdx)
+            {
+                return mIdx < head && isAvailable(mIdx);
+            });
+        auto findKey([&](size_t mIdx, size_t& mKey)
+            {
+                for(mKey = mIdx; isUsable(mKey); --mKey)
+                    if(frames[mKey % frameCount].key)
+                        return true;
+                    else if(mKey == 0)
+                        break;
+                return false;
+            });
+
+        // Go as far back as asked, or to the oldest frame that still has a
+        // buffered key frame before it
+        size_t target{head - 1 - std::min(mSteps, head - 1)}, key{0};
+        for(;; ++target)
+        {
+            if(target >= head) return false;
+            if(isUsable(target) && findKey(target, key)) break;
+        }
+
+        LDCPhysics* playerPhysics{nullptr};
+        LDCPlayer* player{nullptr};
+        if(mManager.hasEntity(LDGroup::Player))
+        {
+            auto& e(*mManager.getEntities(LDGroup::Player)[0]);
+            playerPhysics = &e.getComponent<LDCPhysics>();
+            player = &e.getComponent<LDCPlayer>();
+        }
+
+        LDCBlock* carried{nullptr};
+        for(auto i(key); i <= target; ++i)
+        {
+            const auto& frame(frames[i % frameCount]);
+            for(auto j(frame.first); j < frame.first + frame.count; ++j)
+            {
+                const auto& entry(pool[j % poolSize]);
+                if(!mManager.isAlive(entry.stat)) continue;
+
+                auto& cPhysics(entry.entity->getComponent<LDCPhysics>());
+                cPhysics.getBody().setPosition(entry.position);
+                cPhysics.setVelocity(entry.velocity);
+
+                auto block(entry.block);
+                if(block == nullptr) continue;
+
+                block->setParent(entry.carried ? playerPhysics : nullptr);
+                if(entry.carried)
+                    carried = block;
+                else if(carried == block)
+                    carried = nullptr;
+            }
+        }
+
+        const auto& frame(frames[target % frameCount]);
+        mTimer = frame.timer;
+        mStarted = frame.started;
+        if(player != nullptr && frame.hasPlayer)
+            player->setState(frame.player, carried);
+
+        // The undone steps are gone: capturing resumes from the target
+        head = target + 1;
+        written = frame.first + frame.count;
+        // Bodies that appeared after the target were marked as recorded
+        // by the dropped frames: start over from a key frame
+        sinceKey = keyInterval;
+        return true;
+    }
+}
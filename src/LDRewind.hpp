@@ -0,0 +1,94 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_REWIND
+#define SSVLD_REWIND
+
+#include "LDDependencies.hpp"
+#include "LDCPhysics.hpp"
+#include "LDCPlayer.hpp"
+
+namespace ld
+{
+    // Ring buffer of per-step snapshots. Every `keyInterval` steps a key
+    // frame stores every block, lift and the player; the frames in between
+    // only store what moved, what is carried, the player and bodies never
+    // stored before (spawned or streamed in since), so every body present
+    // at a step can be put back where it was. Entries live in a
+    // preallocated circular pool, so capturing never allocates; when the
+    // pool wraps, the oldest frames become unusable.
+    // Restoring replays the closest key frame and the following deltas.
+    // Entities destroyed since (received, crushed or unloaded) are not
+    // brought back.
+    class LDRewind
+    {
+    public:
+        static constexpr std::size_t frameCount{60 * 5};
+        static constexpr std::size_t poolSize{1 << 16};
+        static constexpr std::size_t keyInterval{30};
+
+    private:
+        struct Entry
+        {
+            sses::Entity* entity;
+            LDCBlock* block; // Null for the player and lifts
+            sses::EntityStat stat;
+            ssvs::Vec2i position;
+            ssvs::Vec2f velocity;
+            bool carried;
+        };
+
+        struct Frame
+        {
+            std::size_t index;        // Step number, to detect reuse
+            std::size_t first, count; // Position in the entry stream
+            bool key, valid{false};
+            Ticker timer{0.f};
+            bool started;
+            bool hasPlayer;
+            LDCPlayer::State player;
+        };
+
+        std::vector<Entry> pool;
+        std::array<Frame, frameCount> frames;
+        std::size_t written{0}; // Total entries ever written
+        std::size_t oldest{0};  // Entries before this were overwritten
+        std::size_t head{0};    // Total frames ever captured
+        std::size_t sinceKey{keyInterval};
+
+        inline void push(sses::Entity& mEntity, LDCPhysics& mCPhysics,
+            LDCBlock* mCBlock)
+        {
+            pool[written++ % poolSize] = {&mEntity, mCBlock, mEntity.getStat(),
+                mCPhysics.getPos(), mCPhysics.getVelocity(),
+                mCBlock != nullptr && mCBlock->hasParent()};
+            mCPhysics.setRecorded(true);
+        }
+        inline bool isAvailable(std::size_t mIdx) const noexcept
+        {
+            const auto& f(frames[mIdx % frameCount]);
+            return f.valid && f.index == mIdx && f.first >= oldest;
+        }
+
+    public:
+        inline LDRewind() : pool(poolSize) {}
+
+        // Records the state at the end of the current step
+        void capture(sses::Manager& mManager, const Ticker& mTimer,
+            bool mStarted);
+
+        // Goes back `mSteps` steps (or as far as the buffer allows); the
+        // steps undone are dropped. Returns false if nothing is buffered
+        bool restore(sses::Manager& mManager, Ticker& mTimer, bool& mStarted,
+            std::size_t mSteps);
+
+        inline void clear() noexcept
+        {
+            for(auto& f : frames) f.valid = false;
+            sinceKey = keyInterval;
+        }
+    };
+}
+
+#endif
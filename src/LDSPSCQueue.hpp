@@ -0,0 +1,58 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_SPSCQUEUE
+#define SSVLD_SPSCQUEUE
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace ld
+{
+    // Bounded lock-free single-producer/single-consumer ring buffer.
+    // `push` is only called from one thread and `pop` only from another;
+    // neither ever blocks: a full queue rejects, an empty one returns false.
+    template <typename T, std::size_t TSize>
+    class LDSPSCQueue
+    {
+        static_assert((TSize & (TSize - 1)) == 0, "size must be a power of 2");
+
+    private:
+        static constexpr std::size_t mask{TSize - 1};
+
+        std::array<T, TSize> items;
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::atomic<std::size_t> tail{0};
+
+    public:
+        inline bool push(const T& mItem) noexcept
+        {
+            const auto t(tail.load(std::memory_order_relaxed));
+            if(t - head.load(std::memory_order_acquire) == TSize) return false;
+
+            items[t & mask] = mItem;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline bool pop(T& mItem) noexcept
+        {
+            const auto h(head.load(std::memory_order_relaxed));
+            if(h == tail.load(std::memory_order_acquire)) return false;
+
+            mItem = items[h & mask];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline bool isEmpty() const noexcept
+        {
+            return head.load(std::memory_order_acquire) ==
+                   tail.load(std::memory_order_acquire);
+        }
+    };
+}
+
+#endif
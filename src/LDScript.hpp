@@ -0,0 +1,177 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_SCRIPT
+#define SSVLD_SCRIPT
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    enum class LDSignal : unsigned int
+    {
+        MessageFinished,
+        BlockReceived,
+        BlockCrushed,
+        LevelStarted,
+        Count
+    };
+
+    class LDScriptManager;
+
+    // Level script: a sequence of actions and waits. A wait either polls
+    // its predicate every update (fallback) or is suspended until one of
+    // its signals is emitted, costing nothing in the meantime.
+    class LDScript
+    {
+        friend class LDScriptManager;
+
+    private:
+        struct Step
+        {
+            std::function<void()> action;
+            std::function<bool()> predicate;
+            unsigned int signalMask;
+        };
+
+        std::vector<Step> steps;
+        std::size_t current{0};
+
+        // Bumped every time the script suspends, whatever it waits on:
+        // registrations from earlier suspensions are recognized as stale
+        // and skipped, so a script is never resumed twice for one wait
+        unsigned int generation{0};
+
+        template <typename... TSignals>
+        inline static unsigned int getMask(TSignals... mSignals) noexcept
+        {
+            unsigned int result{0};
+            (void)std::initializer_list<int>{
+                (result |= 1u << static_cast<unsigned int>(mSignals), 0)...};
+            return result;
+        }
+
+    public:
+        inline LDScript& then(std::function<void()> mAction)
+        {
+            steps.push_back({std::move(mAction), nullptr, 0});
+            return *this;
+        }
+
+        // Waits while `mPredicate` holds; re-checked only when one of
+        // `mSignals` is emitted, or every update if none are given
+        template <typename... TSignals>
+        inline LDScript& waitWhile(
+            std::function<bool()> mPredicate, TSignals... mSignals)
+        {
+            steps.push_back(
+                {nullptr, std::move(mPredicate), getMask(mSignals...)});
+            return *this;
+        }
+
+        inline bool isFinished() const noexcept
+        {
+            return current >= steps.size();
+        }
+    };
+
+    class LDScriptManager
+    {
+    private:
+        struct Waiter
+        {
+            LDScript* script;
+            unsigned int generation;
+        };
+
+        static constexpr std::size_t signalCount{
+            static_cast<std::size_t>(LDSignal::Count)};
+
+        std::vector<ssvu::UPtr<LDScript>> scripts;
+        std::vector<LDScript*> pending;
+        std::vector<Waiter> polled, resumed;
+        std::array<std::vector<Waiter>, signalCount> waiters;
+
+        inline static bool isCurrent(const Waiter& mW) noexcept
+        {
+            return mW.generation == mW.script->generation;
+        }
+
+        // Runs `mScript` until it has to wait again or it ends
+        inline void resume(LDScript& mScript)
+        {
+            while(!mScript.isFinished())
+            {
+                auto& step(mScript.steps[mScript.current]);
+
+                if(step.predicate == nullptr)
+                {
+                    ++mScript.current;
+                    step.action();
+                    continue;
+                }
+
+                if(!step.predicate())
+                {
+                    ++mScript.current;
+                    continue;
+                }
+
+                const Waiter w{&mScript, ++mScript.generation};
+                if(step.signalMask == 0)
+                {
+                    polled.push_back(w);
+                    return;
+                }
+
+                for(auto i(0u); i < signalCount; ++i)
+                    if(step.signalMask & (1u << i)) waiters[i].push_back(w);
+                return;
+            }
+        }
+
+    public:
+        inline LDScript& create()
+        {
+            scripts.emplace_back(ssvu::mkUPtr<LDScript>());
+            pending.push_back(scripts.back().get());
+            return *scripts.back();
+        }
+
+        inline void signal(LDSignal mSignal)
+        {
+            auto& list(waiters[static_cast<std::size_t>(mSignal)]);
+            if(list.empty()) return;
+
+            // Resumed scripts may register again (or emit signals)
+            auto signaled(std::move(list));
+            list.clear();
+
+            for(const auto& w : signaled)
+                if(isCurrent(w)) resume(*w.script);
+        }
+
+        // Starts newly created scripts and re-checks polling waits
+        inline void update()
+        {
+            resumed.clear();
+            std::swap(resumed, polled);
+            for(auto s : pending) resumed.push_back({s, s->generation});
+            pending.clear();
+
+            for(const auto& w : resumed)
+                if(isCurrent(w)) resume(*w.script);
+        }
+
+        inline void clear()
+        {
+            scripts.clear();
+            pending.clear();
+            polled.clear();
+            for(auto& l : waiters) l.clear();
+        }
+    };
+}
+
+#endif
@@ -6,6 +6,7 @@
 #define SSVLD_SENSOR
 
 #include "LDDependencies.hpp"
+#include "LDDelegate.hpp"
 #include "LDGroups.hpp"
 
 namespace ld
@@ -22,7 +23,7 @@ namespace ld
         bool active{false};
 
     public:
-        ssvu::Delegate<void(sses::Entity&)> onDetection;
+        LDDelegate<void(sses::Entity&)> onDetection;
 
         LDSensor(Body& mParent, const ssvs::Vec2i& mSize)
             : parent(mParent), position(parent.getPosition()),
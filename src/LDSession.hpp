@@ -0,0 +1,48 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_SESSION
+#define SSVLD_SESSION
+
+#include "LDDependencies.hpp"
+#include "LDLevelGenerator.hpp"
+
+namespace ld
+{
+    // The level being played, never any state: enough for a co-op peer or
+    // a spectator to build the same level
+    struct LDSession
+    {
+        int level{0};
+        bool generated{false};
+        LDGenSettings genSettings;
+    };
+
+    inline sf::Packet& operator<<(sf::Packet& mP, const LDSession& mS)
+    {
+        return mP << sf::Int32(mS.level) << mS.generated
+                  << sf::Uint32(mS.genSettings.seed)
+                  << sf::Int32(mS.genSettings.columns)
+                  << sf::Int32(mS.genSettings.floors)
+                  << sf::Int32(mS.genSettings.colors)
+                  << sf::Int32(mS.genSettings.pileEvery);
+    }
+    inline sf::Packet& operator>>(sf::Packet& mP, LDSession& mS)
+    {
+        sf::Int32 level, columns, floors, colors, pileEvery;
+        sf::Uint32 seed;
+        mP >> level >> mS.generated >> seed >> columns >> floors >> colors >>
+            pileEvery;
+
+        mS.level = level;
+        mS.genSettings.seed = seed;
+        mS.genSettings.columns = columns;
+        mS.genSettings.floors = floors;
+        mS.genSettings.colors = colors;
+        mS.genSettings.pileEvery = pileEvery;
+        return mP;
+    }
+}
+
+#endif
@@ -0,0 +1,318 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include <atomic>
+#include <queue>
+#include <thread>
+#include <unordered_set>
+
+#include "LDSolver.hpp"
+
+using namespace ssvs;
+using namespace std;
+
+namespace ld
+{
+    namespace
+    {
+        constexpr int tileSize{3200}, tileOrigin{1000}, maxFall{128};
+        constexpr float walkCost{3200.f / 150.f}, stepCost{walkCost * 1.5f},
+            jumpCost{walkCost * 2.f}, fallCost{4.f};
+        constexpr float unreached{numeric_limits<float>::max()};
+
+        inline Vec2i toTile(const Vec2i& mPos) noexcept
+        {
+            return {getCellCoord(mPos.x - tileOrigin + tileSize / 2, tileSize),
+                getCellCoord(mPos.y - tileOrigin + tileSize / 2, tileSize)};
+        }
+
+        using Edges = vector<pair<int, float>>;
+
+        // Graph of the tiles the player can stand on, built lazily from the
+        // spawn: only the reachable part of the level is ever expanded
+        class Graph
+        {
+        private:
+            unordered_set<uint64_t> solid;
+            unordered_map<uint64_t, int> ids;
+            unordered_map<uint64_t, vector<pair<Vec2i, float>>> links;
+
+        public:
+            vector<Vec2i> nodes;
+            vector<Edges> edges;
+
+            inline bool isSolid(int mX, int mY) const
+            {
+                return solid.count(getCellKey(mX, mY)) > 0;
+            }
+            inline bool isStand(int mX, int mY) const
+            {
+                return !isSolid(mX, mY) && isSolid(mX, mY + 1);
+            }
+
+            inline void addSolid(const Vec2i& mTile)
+            {
+                solid.emplace(getCellKey(mTile.x, mTile.y));
+            }
+            inline void addLink(
+                const Vec2i& mFrom, const Vec2i& mTo, float mCost)
+            {
+                links[getCellKey(mFrom.x, mFrom.y)].emplace_back(mTo, mCost);
+            }
+
+            inline int getNode(int mX, int mY)
+            {
+                const auto key(getCellKey(mX, mY));
+                auto itr(ids.find(key));
+                if(itr != end(ids)) return itr->second;
+
+                ids.emplace(key, nodes.size());
+                nodes.emplace_back(mX, mY);
+                edges.emplace_back();
+                return nodes.size() - 1;
+            }
+            inline int findNode(int mX, int mY) const
+            {
+                auto itr(ids.find(getCellKey(mX, mY)));
+                return itr == end(ids) ? -1 : itr->second;
+            }
+
+            // Node reached by dropping from (mX, mY), with the rows fallen
+            inline pair<int, int> fall(int mX, int mY)
+            {
+                for(int i{0}; i < maxFall; ++i)
+                {
+                    if(isSolid(mX, mY + i)) return {-1, 0};
+                    if(isStand(mX, mY + i)) return {getNode(mX, mY + i), i};
+                }
+                return {-1, 0};
+            }
+
+            inline void expand(int mNode)
+            {
+                const auto p(nodes[mNode]);
+                Edges result;
+
+                for(int dx : {-1, 1})
+                {
+                    const int nx{p.x + dx};
+                    const bool headroom{!isSolid(p.x, p.y - 1)};
+
+                    if(!isSolid(nx, p.y))
+                    {
+                        const auto f(fall(nx, p.y));
+                        if(f.first != -1)
+                            result.emplace_back(
+                                f.first, walkCost + f.second * fallCost);
+
+                        // Gap jump over a single column
+                        if(headroom && !isSolid(nx, p.y - 1))
+                            for(int dy : {0, -1})
+                                if(isStand(p.x + 2 * dx, p.y + dy))
+                                    result.emplace_back(
+                                        getNode(p.x + 2 * dx, p.y + dy),
+                                        jumpCost);
+                    }
+                    else if(headroom && isStand(nx, p.y - 1))
+                        result.emplace_back(getNode(nx, p.y - 1), stepCost);
+                }
+
+                auto itr(links.find(getCellKey(p.x, p.y)));
+                if(itr != end(links))
+                    for(const auto& l : itr->second)
+                        result.emplace_back(getNode(l.first.x, l.first.y),
+                            l.second);
+
+                edges[mNode] = move(result);
+            }
+        };
+
+        template <typename TEdges>
+        inline vector<float> getDistances(
+            const TEdges& mEdges, const vector<int>& mSources)
+        {
+            using Entry = pair<float, int>;
+            vector<float> result(mEdges.size(), unreached);
+            priority_queue<Entry, vector<Entry>, greater<Entry>> queue;
+
+            for(auto s : mSources)
+            {
+                result[s] = 0.f;
+                queue.emplace(0.f, s);
+            }
+
+            while(!queue.empty())
+            {
+                const auto top(queue.top());
+                queue.pop();
+                if(top.first > result[top.second]) continue;
+
+                for(const auto& e : mEdges[top.second])
+                {
+                    const auto d(top.first + e.second);
+                    if(d >= result[e.first]) continue;
+                    result[e.first] = d;
+                    queue.emplace(d, e.first);
+                }
+            }
+
+            return result;
+        }
+
+        // Reachable nodes within a tile window around `mTile`
+        inline vector<int> getNodesAround(const Graph& mGraph,
+            const Vec2i& mTile, int mUp, int mDown,
+            const vector<float>& mReach)
+        {
+            vector<int> result;
+            for(int y{mTile.y - mUp}; y <= mTile.y + mDown; ++y)
+                for(int x{mTile.x - 1}; x <= mTile.x + 1; ++x)
+                {
+                    const auto n(mGraph.findNode(x, y));
+                    if(n != -1 && mReach[n] != unreached) result.push_back(n);
+                }
+            return result;
+        }
+    }
+
+    LDSolverReport LDSolver::check(const LDLevelData& mLevel)
+    {
+        LDSolverReport report;
+        report.title = mLevel.title;
+
+        Graph graph;
+        vector<pair<Vec2i, int>> blocks, receivers;
+        vector<Vec2i> teles;
+
+        for(const auto& r : mLevel.records)
+        {
+            const auto tile(toTile(r.position));
+            switch(r.kind)
+            {
+                case LDRecordKind::Wall: graph.addSolid(tile); break;
+                case LDRecordKind::Receiver:
+                    receivers.emplace_back(tile, r.val);
+                    break;
+                case LDRecordKind::Tele: teles.emplace_back(tile); break;
+                default: blocks.emplace_back(tile, r.val); break;
+            }
+        }
+
+        // Lifts connect the tiles around each pair of consecutive stops;
+        // the cost includes waiting for a whole round trip
+        for(auto i(0u); i < mLevel.lifts.size(); ++i)
+        {
+            const auto& path(mLevel.lifts[i]);
+            for(auto j(0u); j + 1 < path.size(); ++j)
+            {
+                const auto a(toTile(path[j])), b(toTile(path[j + 1]));
+                const auto cost(2.f * getMag(Vec2f(path[j + 1] - path[j])) /
+                                mLevel.liftSpeeds[i]);
+
+                for(int ay{-1}; ay <= 1; ++ay)
+                    for(int ax{-1}; ax <= 1; ++ax)
+                    {
+                        const Vec2i ea{a.x + ax, a.y + ay};
+                        if(!graph.isStand(ea.x, ea.y)) continue;
+
+                        for(int by{-1}; by <= 1; ++by)
+                            for(int bx{-1}; bx <= 1; ++bx)
+                            {
+                                const Vec2i eb{b.x + bx, b.y + by};
+                                if(!graph.isStand(eb.x, eb.y)) continue;
+                                graph.addLink(ea, eb, cost);
+                                graph.addLink(eb, ea, cost);
+                            }
+                    }
+            }
+        }
+
+        // Expand everything reachable from the spawn
+        const auto spawnTile(toTile(mLevel.spawn));
+        const auto spawn(graph.fall(spawnTile.x, spawnTile.y).first);
+        if(spawn == -1) return report;
+
+        for(auto i(0u); i < graph.nodes.size(); ++i) graph.expand(i);
+        report.nodes = graph.nodes.size();
+
+        const auto reach(getDistances(graph.edges, {spawn}));
+
+        vector<Edges> reversed(graph.edges.size());
+        for(auto i(0u); i < graph.edges.size(); ++i)
+            for(const auto& e : graph.edges[i])
+                reversed[e.first].emplace_back(i, e.second);
+
+        // One reverse search per block value: distance from every node to
+        // the closest receiver accepting that value
+        unordered_map<int, vector<float>> toReceiver;
+        for(const auto& b : blocks)
+        {
+            if(toReceiver.count(b.second) > 0) continue;
+
+            vector<int> sources;
+            for(const auto& r : receivers)
+                if(r.second == -1 || r.second == b.second)
+                    for(auto n : getNodesAround(graph, r.first, 1, 0, reach))
+                        sources.push_back(n);
+
+            toReceiver[b.second] = getDistances(reversed, sources);
+        }
+
+        report.blocks = blocks.size();
+        for(const auto& b : blocks)
+        {
+            // Optimistic: piles are assumed climbable, so the top block is
+            // always in reach
+            const auto pickups(getNodesAround(graph, b.first, 3, 1, reach));
+            if(pickups.empty())
+            {
+                ++report.unreachable;
+                continue;
+            }
+
+            float best{unreached};
+            for(auto n : pickups)
+                best = std::min(best, toReceiver[b.second][n]);
+
+            if(best == unreached)
+            {
+                ++report.undeliverable;
+                continue;
+            }
+
+            // Carrying it there, plus walking back from the last receiver
+            const auto delivery(best * 2.f);
+            report.worstDelivery =
+                std::max(report.worstDelivery, delivery / 60.f);
+            if(mLevel.timed && delivery > timeLimit) ++report.late;
+        }
+
+        for(const auto& t : teles)
+            if(!getNodesAround(graph, t, 1, 1, reach).empty())
+                report.teleReachable = true;
+
+        return report;
+    }
+
+    vector<LDSolverReport> LDSolver::checkAll(
+        const vector<LDLevelData>& mLevels)
+    {
+        vector<LDSolverReport> result(mLevels.size());
+        atomic<size_t> next{0};
+
+        auto work([&]
+            {
+                for(auto i(next++); i < mLevels.size(); i = next++)
+                    result[i] = check(mLevels[i]);
+            });
+
+        const auto count(std::max(1u, thread::hardware_concurrency()));
+        vector<thread> workers;
+        for(auto i(1u); i < count; ++i) workers.emplace_back(work);
+        work();
+        for(auto& w : workers) w.join();
+
+        return result;
+    }
+}
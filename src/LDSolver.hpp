@@ -0,0 +1,67 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_SOLVER
+#define SSVLD_SOLVER
+
+#include "LDDependencies.hpp"
+#include "LDLevelStream.hpp"
+
+namespace ld
+{
+    // Everything the solver needs to know about a level, in world
+    // coordinates (as placed by `LDGame`'s placement helpers)
+    struct LDLevelData
+    {
+        std::string title;
+        std::vector<LDRecord> records;
+        std::vector<std::vector<ssvs::Vec2i>> lifts;
+        std::vector<float> liftSpeeds;
+        ssvs::Vec2i spawn;
+        bool timed{true};
+    };
+
+    struct LDSolverReport
+    {
+        std::string title;
+        std::size_t nodes{0}, blocks{0};
+        std::size_t unreachable{0};   // Blocks the player cannot get to
+        std::size_t undeliverable{0}; // Blocks with no reachable receiver
+        std::size_t late{0};          // Deliveries over the time limit
+        float worstDelivery{0.f};     // Seconds
+        bool teleReachable{false};
+
+        inline bool isSolvable() const noexcept
+        {
+            return teleReachable && unreachable == 0 && undeliverable == 0 &&
+                   late == 0;
+        }
+    };
+
+    // Headless solvability heuristic. This is a static reachability pass
+    // over the level data, not a search over inputs: the level is turned
+    // into a graph of tiles the player can stand on, with edges for
+    // walking, stepping, falling, gap jumps and lifts weighted by travel
+    // time, and searches over that graph tell if every block could be
+    // carried to a matching receiver, and the teleporter reached, within
+    // the time limit. It is optimistic: blocks are treated as movable and
+    // piles as climbable, so a failed check means the level is broken,
+    // while a passing one does not prove it can be finished. Playing
+    // levels through by branching on inputs is not done: rewind frames
+    // cannot bring back delivered or crushed blocks, and there is a single
+    // collision world, so workers have no simulation of their own to fork.
+    class LDSolver
+    {
+    public:
+        static constexpr float timeLimit{10.f * 60.f}; // In frametime units
+
+        static LDSolverReport check(const LDLevelData& mLevel);
+
+        // Checks every level on its own worker, using every core
+        static std::vector<LDSolverReport> checkAll(
+            const std::vector<LDLevelData>& mLevels);
+    };
+}
+
+#endif
@@ -0,0 +1,151 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_SOUNDPOOL
+#define SSVLD_SOUNDPOOL
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    enum class LDSound : int
+    {
+        Blip,
+        Bounce,
+        Death,
+        Drop,
+        Expl,
+        Jump,
+        Pick,
+        Recv,
+        Step,
+        Tele,
+        Count
+    };
+
+    struct LDSoundInfo
+    {
+        const char* name;
+        int priority;
+        float minInterval; // Seconds between two starts of the same sound
+    };
+
+    inline const LDSoundInfo& getSoundInfo(LDSound mSound) noexcept
+    {
+        static constexpr LDSoundInfo infos[]{{"blip.wav", 1, 0.f},
+            {"bounce.wav", 0, 0.06f}, {"death.wav", 3, 0.f},
+            {"drop.wav", 1, 0.f}, {"expl.wav", 2, 0.f}, {"jump.wav", 1, 0.f},
+            {"pick.wav", 1, 0.f}, {"recv.wav", 2, 0.05f},
+            {"step.wav", 0, 0.1f}, {"tele.wav", 3, 0.f}};
+
+        return infos[static_cast<int>(mSound)];
+    }
+
+    // Fixed-size pool of voices. Sound buffers are resolved once into an
+    // array indexed by `LDSound`; playing never looks up strings and never
+    // allocates. When every voice is busy, the oldest voice with the lowest
+    // priority not above the new sound's is stolen.
+    class LDSoundPool
+    {
+    public:
+        using Mode = ssvs::SoundPlayer::Mode;
+        static constexpr int soundCount{static_cast<int>(LDSound::Count)};
+        static constexpr std::size_t voiceCount{24};
+
+    private:
+        struct Voice
+        {
+            sf::Sound sound;
+            LDSound id{LDSound::Count};
+            int priority{0};
+            float startTime{0.f};
+        };
+
+        std::array<const sf::SoundBuffer*, soundCount> buffers{};
+        std::array<float, soundCount> lastStarts{};
+        std::array<Voice, voiceCount> voices;
+        sf::Clock clock;
+        float volume{100.f};
+
+        inline bool isPlaying(const Voice& mVoice) const
+        {
+            return mVoice.sound.getStatus() == sf::Sound::Playing;
+        }
+
+        inline Voice* getVoice(int mPriority)
+        {
+            Voice* result{nullptr};
+            for(auto& v : voices)
+            {
+                if(!isPlaying(v)) return &v;
+                if(v.priority > mPriority) continue;
+
+                if(result == nullptr || v.priority < result->priority ||
+                    (v.priority == result->priority &&
+                        v.startTime < result->startTime))
+                    result = &v;
+            }
+            return result;
+        }
+
+    public:
+        inline LDSoundPool()
+        {
+            for(auto& t : lastStarts) t = -1000.f;
+        }
+
+        template <typename TAssetManager>
+        inline void resolve(TAssetManager& mAssetManager)
+        {
+            for(int i{0}; i < soundCount; ++i)
+                buffers[i] = &mAssetManager.template get<sf::SoundBuffer>(
+                    getSoundInfo(LDSound(i)).name);
+        }
+
+        inline void play(
+            LDSound mSound, Mode mMode = Mode::Overlap, float mPitch = 1.f)
+        {
+            const auto idx(static_cast<int>(mSound));
+            const auto& info(getSoundInfo(mSound));
+            const auto now(clock.getElapsedTime().asSeconds());
+
+            if(now - lastStarts[idx] < info.minInterval) return;
+
+            if(mMode != Mode::Overlap)
+                for(auto& v : voices)
+                {
+                    if(v.id != mSound || !isPlaying(v)) continue;
+                    if(mMode == Mode::Abort) return;
+                    v.sound.stop();
+                }
+
+            auto voice(getVoice(info.priority));
+            if(voice == nullptr) return;
+
+            lastStarts[idx] = now;
+            voice->sound.stop();
+            voice->sound.setBuffer(*buffers[idx]);
+            voice->sound.setPitch(mPitch);
+            voice->sound.setVolume(volume);
+            voice->sound.play();
+            voice->id = mSound;
+            voice->priority = info.priority;
+            voice->startTime = now;
+        }
+
+        inline void stop()
+        {
+            for(auto& v : voices) v.sound.stop();
+        }
+
+        inline void setVolume(float mVolume)
+        {
+            volume = mVolume;
+            for(auto& v : voices) v.sound.setVolume(volume);
+        }
+        inline float getVolume() const noexcept { return volume; }
+    };
+}
+
+#endif
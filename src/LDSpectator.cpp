@@ -0,0 +1,375 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include <algorithm>
+#include <limits>
+
+#include "LDGame.hpp"
+#include "LDSpectator.hpp"
+#include "LDCPhysics.hpp"
+
+using namespace ssvs;
+using namespace sses;
+using namespace std;
+
+namespace ld
+{
+    namespace
+    {
+        inline bool fitsDelta(int mValue) noexcept
+        {
+            return mValue >= numeric_limits<sf::Int16>::min() &&
+                   mValue <= numeric_limits<sf::Int16>::max();
+        }
+    }
+
+    bool LDSpectator::start(unsigned short mPort, float mBytesPerSecond)
+    {
+        if(running) return true;
+        if(listener.listen(mPort) != sf::Socket::Done) return false;
+
+        listener.setBlocking(false);
+        bytesPerSecond = mBytesPerSecond;
+        bytesSent = framesDropped = 0;
+        running = true;
+        thread = std::thread{[this]
+            {
+                run();
+            }};
+        return true;
+    }
+    void LDSpectator::stop()
+    {
+        running = false;
+        wakeSignal.notify();
+        if(thread.joinable()) thread.join();
+
+        // A restarted server hands out fresh ids from empty buffers
+        tracked.clear();
+        nextId = 0;
+        for(auto& f : frames) f.bodies.clear();
+        middle = 1;
+        back = 0;
+        front = 2;
+    }
+
+    void LDSpectator::setSession(const LDSession& mSession)
+    {
+        lock_guard<mutex> lock{sessionMutex};
+        session = mSession;
+        ++sessionId;
+    }
+
+    void LDSpectator::capture(Manager& mManager)
+    {
+        ++step;
+        if(clientCount == 0)
+        {
+            // Nothing to encode: the encoder only wakes now and then to
+            // accept viewers. With no steps (menu, pause) it never wakes
+            if(step % acceptInterval != 0) return;
+            tick = true;
+            wakeSignal.notify();
+            return;
+        }
+
+        auto& frame(frames[back]);
+        frame.step = step;
+        frame.bodies.clear();
+
+        auto add([&](Entity& mEntity, LDSpectatorKind mKind)
+            {
+                auto& t(tracked[&mEntity]);
+                if(t.id == 0 || !mManager.isAlive(t.stat))
+                    t = {mEntity.getStat(), ++nextId};
+
+                frame.bodies.push_back({t.id, mKind,
+                    mEntity.getComponent<LDCPhysics>().getPos()});
+            });
+
+        for(auto& e : mManager.getEntities(LDGroup::Block))
+            add(*e, LDSpectatorKind::Block);
+        for(auto& e : mManager.getEntities(LDGroup::Lift))
+            add(*e, LDSpectatorKind::Lift);
+        for(auto& e : mManager.getEntities(LDGroup::Player))
+            add(*e, LDSpectatorKind::Player);
+        for(auto& e : mManager.getEntities(LDGroup::Receiver))
+            add(*e, LDSpectatorKind::Receiver);
+        for(auto& e : mManager.getEntities(LDGroup::Tele))
+            add(*e, LDSpectatorKind::Tele);
+
+        // Forget destroyed entities once they pile up
+        if(tracked.size() > frame.bodies.size() * 2 + 256)
+            for(auto itr(begin(tracked)); itr != end(tracked);)
+                if(mManager.isAlive(itr->second.stat))
+                    ++itr;
+                else
+                    itr = tracked.erase(itr);
+
+        back = middle.exchange(back | freshBit) & ~freshBit;
+        wakeSignal.notify();
+    }
+
+    void LDSpectator::run()
+    {
+        sf::Clock clock;
+        while(running)
+        {
+            accept();
+
+            // Each client may bank up to one second of bandwidth
+            const auto elapsed(clock.restart().asSeconds());
+            for(auto& c : clients)
+                c.budget = std::min(
+                    c.budget + elapsed * bytesPerSecond, bytesPerSecond);
+
+            if((middle.load() & freshBit) == 0)
+            {
+                // Partial sends are retried once per step, with the frames
+                for(auto& c : clients) flush(c);
+                wakeSignal.wait([this]
+                    {
+                        return (middle.load() & freshBit) != 0 || tick ||
+                               !running;
+                    });
+                tick = false;
+                continue;
+            }
+
+            front = middle.exchange(front) & ~freshBit;
+            const auto& frame(frames[front]);
+
+            current.clear();
+            for(const auto& b : frame.bodies)
+                current.push_back({b.id, b.kind,
+                    {quantize(b.position.x), quantize(b.position.y)}});
+            sort(begin(current), end(current),
+                [](const LDSpectatorBody& mA, const LDSpectatorBody& mB)
+                {
+                    return mA.id < mB.id;
+                });
+
+            for(auto& c : clients)
+            {
+                // A client still sending, or over budget, skips the frame:
+                // the next one it gets carries the accumulated changes
+                if(!flush(c) || c.hasPending || c.budget < 0.f)
+                {
+                    ++framesDropped;
+                    continue;
+                }
+
+                // A new level restarts the viewer from its session header
+                if(c.session != sessionId)
+                    encodeSession(c);
+                else
+                    encode(c, frame.step);
+                flush(c);
+            }
+
+            clients.erase(remove_if(begin(clients), end(clients),
+                              [](const Client& mC)
+                              {
+                                  return mC.socket == nullptr;
+                              }),
+                end(clients));
+            clientCount = clients.size();
+        }
+
+        clients.clear();
+        clientCount = 0;
+        listener.close();
+    }
+
+    void LDSpectator::accept()
+    {
+        while(clients.size() < maxClients)
+        {
+            auto socket(ssvu::mkUPtr<sf::TcpSocket>());
+            if(listener.accept(*socket) != sf::Socket::Done) break;
+
+            socket->setBlocking(false);
+            clients.emplace_back();
+            clients.back().socket = std::move(socket);
+            clients.back().budget = bytesPerSecond;
+        }
+        clientCount = clients.size();
+    }
+
+    void LDSpectator::encode(Client& mClient, std::uint32_t mStep)
+    {
+        destroyed.clear();
+        created.clear();
+        moved.clear();
+
+        // Both lists are sorted by id: a single merge pass finds the changes
+        const auto& old(mClient.baseline);
+        auto i(0u), j(0u);
+        while(i < old.size() || j < current.size())
+        {
+            if(j == current.size() ||
+                (i < old.size() && old[i].id < current[j].id))
+                destroyed.push_back(old[i++].id);
+            else if(i == old.size() || current[j].id < old[i].id)
+                created.push_back(current[j++]);
+            else
+            {
+                const auto delta(current[j].position - old[i].position);
+                if(!fitsDelta(delta.x) || !fitsDelta(delta.y))
+                {
+                    // Too far for a delta: the viewer recreates it
+                    destroyed.push_back(current[j].id);
+                    created.push_back(current[j]);
+                }
+                else if(delta != Vec2i{0, 0})
+                    moved.push_back({current[j].id, current[j].kind, delta});
+                ++i;
+                ++j;
+            }
+        }
+
+        auto& p(mClient.pending);
+        p.clear();
+        p << sf::Uint8(LDSpectatorPacket::Frame) << sf::Uint32(mStep);
+        p << sf::Uint32(destroyed.size());
+        for(auto id : destroyed) p << sf::Uint32(id);
+        p << sf::Uint32(created.size());
+        for(const auto& b : created)
+            p << sf::Uint32(b.id) << sf::Uint8(b.kind)
+              << sf::Int32(b.position.x) << sf::Int32(b.position.y);
+        p << sf::Uint32(moved.size());
+        for(const auto& b : moved)
+            p << sf::Uint32(b.id) << sf::Int16(b.position.x)
+              << sf::Int16(b.position.y);
+
+        mClient.baseline = current;
+        mClient.hasPending = true;
+        mClient.budget -= p.getDataSize();
+        bytesSent += p.getDataSize();
+    }
+
+    void LDSpectator::encodeSession(Client& mClient)
+    {
+        auto& p(mClient.pending);
+        p.clear();
+        p << sf::Uint8(LDSpectatorPacket::Session);
+        {
+            lock_guard<mutex> lock{sessionMutex};
+            p << session;
+            mClient.session = sessionId;
+        }
+
+        // The viewer drops every body: the next frame recreates them
+        mClient.baseline.clear();
+        mClient.hasPending = true;
+        mClient.budget -= p.getDataSize();
+        bytesSent += p.getDataSize();
+    }
+
+    bool LDSpectator::flush(Client& mClient)
+    {
+        if(mClient.socket == nullptr) return false;
+        if(!mClient.hasPending) return true;
+
+        const auto status(mClient.socket->send(mClient.pending));
+        if(status == sf::Socket::Partial || status == sf::Socket::NotReady)
+            return true;
+
+        mClient.hasPending = false;
+        if(status == sf::Socket::Done) return true;
+
+        // Disconnected: removed at the end of the frame
+        mClient.socket.reset();
+        return false;
+    }
+
+    bool LDSpectatorClient::connect(
+        const sf::IpAddress& mAddress, unsigned short mPort)
+    {
+        disconnect();
+        socket.setBlocking(true);
+        if(socket.connect(mAddress, mPort, sf::seconds(1.f)) !=
+            sf::Socket::Done)
+            return false;
+
+        socket.setBlocking(false);
+        connected = true;
+        return true;
+    }
+    void LDSpectatorClient::disconnect()
+    {
+        socket.disconnect();
+        bodies.clear();
+        step = 0;
+        connected = hasSession = false;
+    }
+
+    void LDSpectatorClient::poll()
+    {
+        sf::Packet packet;
+        while(connected)
+        {
+            const auto status(socket.receive(packet));
+            if(status == sf::Socket::NotReady ||
+                status == sf::Socket::Partial)
+                return;
+
+            if(status != sf::Socket::Done)
+            {
+                disconnect();
+                return;
+            }
+
+            apply(packet);
+        }
+    }
+
+    void LDSpectatorClient::apply(sf::Packet& mPacket)
+    {
+        constexpr int q{LDSpectator::quantum};
+        sf::Uint8 type;
+        sf::Uint32 s, count, id;
+
+        mPacket >> type;
+        if(LDSpectatorPacket(type) == LDSpectatorPacket::Session)
+        {
+            mPacket >> session;
+            hasSession = true;
+            bodies.clear();
+            if(!mPacket) disconnect();
+            return;
+        }
+
+        mPacket >> s >> count;
+        step = s;
+        for(auto i(0u); i < count; ++i)
+        {
+            mPacket >> id;
+            bodies.erase(id);
+        }
+
+        mPacket >> count;
+        for(auto i(0u); i < count; ++i)
+        {
+            sf::Uint8 kind;
+            sf::Int32 x, y;
+            mPacket >> id >> kind >> x >> y;
+            bodies[id] = {id, LDSpectatorKind(kind), Vec2i{x * q, y * q}};
+        }
+
+        mPacket >> count;
+        for(auto i(0u); i < count; ++i)
+        {
+            sf::Int16 dx, dy;
+            mPacket >> id >> dx >> dy;
+
+            auto itr(bodies.find(id));
+            if(itr != end(bodies))
+                itr->second.position += Vec2i{dx * q, dy * q};
+        }
+
+        // A malformed frame leaves the rebuilt state unusable
+        if(!mPacket) disconnect();
+    }
+}
@@ -0,0 +1,195 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_SPECTATOR
+#define SSVLD_SPECTATOR
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "LDDependencies.hpp"
+#include "LDSession.hpp"
+#include "LDWakeSignal.hpp"
+
+namespace ld
+{
+    enum class LDSpectatorKind : std::uint8_t
+    {
+        Block,
+        Lift,
+        Player,
+        Receiver,
+        Tele
+    };
+
+    enum class LDSpectatorPacket : std::uint8_t
+    {
+        Session,
+        Frame
+    };
+
+    struct LDSpectatorBody
+    {
+        std::uint32_t id;
+        LDSpectatorKind kind;
+        ssvs::Vec2i position; // Quantized on the wire
+    };
+
+    // Streams the blocks, lifts, receivers, teleporters and players of
+    // every step to local viewers over TCP. Walls are not streamed: viewers
+    // build the level from the session header, sent on connection and
+    // whenever the level changes. One sf::Packet per message, starting with
+    // a u8 `LDSpectatorPacket`:
+    //   Session: `LDSession` (level, generated, seed, generator settings);
+    //            the viewer drops every body, the next frame recreates them
+    //   Frame:   positions in `quantum` world units
+    //     u32 step
+    //     u32 destroyed, { u32 id }...
+    //     u32 created,   { u32 id, u8 kind, i32 x, i32 y }...
+    //     u32 moved,     { u32 id, i16 dx, i16 dy }...
+    // Deltas are relative to what that client was last sent, so frames can
+    // be dropped freely. The simulation thread only copies positions into
+    // a triple buffer (nothing at all with no clients); quantizing,
+    // diffing and sending happen on the encoder thread, which keeps every
+    // client within a bandwidth budget by dropping frames. The encoder
+    // sleeps until a frame is published: with no clients it only wakes
+    // every `acceptInterval` steps, and not at all while nothing steps.
+    class LDSpectator
+    {
+    public:
+        static constexpr int quantum{25}; // A quarter of a pixel
+        static constexpr std::size_t maxClients{4};
+        static constexpr unsigned short defaultPort{27027};
+        static constexpr std::uint32_t acceptInterval{15}; // In steps
+
+    private:
+        struct Frame
+        {
+            std::uint32_t step;
+            std::vector<LDSpectatorBody> bodies;
+        };
+
+        struct Tracked
+        {
+            sses::EntityStat stat;
+            std::uint32_t id; // Zero until assigned
+        };
+
+        struct Client
+        {
+            ssvu::UPtr<sf::TcpSocket> socket;
+            std::vector<LDSpectatorBody> baseline; // Sorted by id
+            sf::Packet pending;
+            bool hasPending{false};
+            float budget{0.f}; // Bytes, refilled over time
+            std::uint32_t session{0}; // Last session header sent
+        };
+
+        // Simulation side: stable ids, entities can reuse memory
+        std::unordered_map<const sses::Entity*, Tracked> tracked;
+        std::uint32_t nextId{0}, step{0};
+
+        // Handoff: the fresh bit marks a frame the encoder has not seen
+        static constexpr unsigned int freshBit{4};
+        std::array<Frame, 3> frames;
+        std::atomic<unsigned int> middle{1};
+        unsigned int back{0}, front{2};
+        LDWakeSignal wakeSignal;
+
+        // Written rarely by the simulation, copied by the encoder
+        std::mutex sessionMutex;
+        LDSession session;
+        std::atomic<std::uint32_t> sessionId{0};
+
+        // Encoder side
+        sf::TcpListener listener;
+        std::vector<Client> clients;
+        std::vector<LDSpectatorBody> current;
+        std::vector<std::uint32_t> destroyed;
+        std::vector<LDSpectatorBody> created, moved;
+        float bytesPerSecond{0.f};
+        std::thread thread;
+
+        std::atomic<bool> running{false}, tick{false};
+        std::atomic<std::size_t> clientCount{0}, bytesSent{0},
+            framesDropped{0};
+
+        void run();
+        void accept();
+        void encode(Client& mClient, std::uint32_t mStep);
+        void encodeSession(Client& mClient);
+        bool flush(Client& mClient);
+
+    public:
+        inline ~LDSpectator() { stop(); }
+
+        // Listens on `mPort`; each client gets at most `mBytesPerSecond`
+        bool start(unsigned short mPort = defaultPort,
+            float mBytesPerSecond = 256.f * 1024.f);
+        void stop();
+
+        // Called whenever a level is built, before its first capture
+        void setSession(const LDSession& mSession);
+
+        // Called once per step, after the simulation
+        void capture(sses::Manager& mManager);
+
+        // World units to wire units
+        inline static int quantize(int mValue) noexcept
+        {
+            return static_cast<int>(std::floor(mValue / float(quantum) + 0.5f));
+        }
+
+        inline bool isRunning() const noexcept { return running; }
+        inline std::uint32_t getStep() const noexcept { return step; }
+        inline std::size_t getClientCount() const noexcept
+        {
+            return clientCount;
+        }
+        inline std::size_t getBytesSent() const noexcept { return bytesSent; }
+        inline std::size_t getFramesDropped() const noexcept
+        {
+            return framesDropped;
+        }
+    };
+
+    // Viewer side of the protocol: rebuilds the streamed bodies
+    class LDSpectatorClient
+    {
+    private:
+        sf::TcpSocket socket;
+        std::unordered_map<std::uint32_t, LDSpectatorBody> bodies;
+        std::uint32_t step{0};
+        LDSession session;
+        bool connected{false}, hasSession{false};
+
+        void apply(sf::Packet& mPacket);
+
+    public:
+        bool connect(const sf::IpAddress& mAddress,
+            unsigned short mPort = LDSpectator::defaultPort);
+        void disconnect();
+
+        // Applies every frame received since the last call; never blocks
+        void poll();
+
+        inline const std::unordered_map<std::uint32_t, LDSpectatorBody>&
+        getBodies() const noexcept
+        {
+            return bodies;
+        }
+        inline std::uint32_t getStep() const noexcept { return step; }
+        inline const LDSession& getSession() const noexcept
+        {
+            return session;
+        }
+        inline bool isConnected() const noexcept { return connected; }
+        inline bool hasReceivedSession() const noexcept { return hasSession; }
+    };
+}
+
+#endif
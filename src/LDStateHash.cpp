@@ -0,0 +1,178 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#include <fstream>
+
+#include "LDGame.hpp"
+#include "LDStateHash.hpp"
+#include "LDCPhysics.hpp"
+#include "LDCKinematic.hpp"
+#include "LDCPlayer.hpp"
+
+using namespace ssvs;
+using namespace sses;
+using namespace std;
+
+namespace ld
+{
+    namespace
+    {
+        using Hash = LDStateHash::Hash;
+
+        inline void mixPhysics(Hash& mHash, LDCPhysics& mCPhysics)
+        {
+            const auto& body(mCPhysics.getBody());
+            LDStateHash::mix(mHash, body.getPosition().x);
+            LDStateHash::mix(mHash, body.getPosition().y);
+            LDStateHash::mix(mHash, body.getVelocity().x);
+            LDStateHash::mix(mHash, body.getVelocity().y);
+
+            unsigned int groups{0};
+            for(unsigned int g{LDGroup::Solid}; g <= LDGroup::GSensor; ++g)
+                if(body.hasGroup(LDGroup(g))) groups |= 1u << g;
+            LDStateHash::mix(mHash, groups);
+
+            LDStateHash::mix(mHash, body.getStress().x);
+            LDStateHash::mix(mHash, body.getStress().y);
+            LDStateHash::mix(mHash, mCPhysics.getLastResolution().x);
+            LDStateHash::mix(mHash, mCPhysics.getLastResolution().y);
+            LDStateHash::mix(mHash, mCPhysics.getCrushedLeft());
+            LDStateHash::mix(mHash, mCPhysics.getCrushedRight());
+            LDStateHash::mix(mHash, mCPhysics.getCrushedTop());
+            LDStateHash::mix(mHash, mCPhysics.getCrushedBottom());
+            LDStateHash::mix(mHash, mCPhysics.isActive());
+        }
+    }
+
+    void LDStateHash::compute(Manager& mManager)
+    {
+        bodies.clear();
+        entities.clear();
+        total = fnvOffset;
+
+        for(auto& e : mManager.getEntities(LDGroup::Block))
+        {
+            Hash h{fnvOffset};
+            mixPhysics(h, e->getComponent<LDCPhysics>());
+
+            auto& cBlock(e->getComponent<LDCBlock>());
+            mix(h, cBlock.getVal());
+            mix(h, cBlock.hasParent());
+
+            bodies.emplace_back(h);
+            entities.emplace_back(e);
+        }
+
+        for(auto& e : mManager.getEntities(LDGroup::Lift))
+        {
+            Hash h{fnvOffset};
+            mixPhysics(h, e->getComponent<LDCPhysics>());
+
+            const auto& velocity(e->getComponent<LDCKinematic>().getVelocity());
+            mix(h, velocity.x);
+            mix(h, velocity.y);
+
+            bodies.emplace_back(h);
+            entities.emplace_back(e);
+        }
+
+        for(auto& e : mManager.getEntities(LDGroup::Player))
+        {
+            Hash h{fnvOffset};
+            mixPhysics(h, e->getComponent<LDCPhysics>());
+
+            const auto state(e->getComponent<LDCPlayer>().getState());
+            mix(h, static_cast<int>(state.action));
+            mix(h, state.facingLeft);
+            mix(h, state.lastTurn);
+            mix(h, state.lastJump);
+            mix(h, state.stepTime);
+            mix(h, state.lastBlockTimer);
+
+            bodies.emplace_back(h);
+            entities.emplace_back(e);
+        }
+
+        for(auto h : bodies) mix(total, h);
+    }
+
+    void LDHashTrace::record(const LDStateHash& mHash, const LDInput& mInput)
+    {
+        const auto& hashes(mHash.getBodies());
+        steps.push_back({mHash.getTotal(), bodies.size(), hashes.size(),
+            mInput.pack()});
+        bodies.insert(end(bodies), begin(hashes), end(hashes));
+    }
+
+    bool LDHashTrace::verify(const LDStateHash& mHash, Divergence& mResult)
+    {
+        mResult = {cursor, static_cast<size_t>(-1)};
+        if(cursor >= steps.size()) return false;
+
+        const auto& step(steps[cursor]);
+        if(step.total == mHash.getTotal())
+        {
+            ++cursor;
+            return true;
+        }
+
+        const auto& hashes(mHash.getBodies());
+        const auto count(std::min(step.count, hashes.size()));
+        for(auto i(0u); i < count; ++i)
+            if(bodies[step.first + i] != hashes[i])
+            {
+                mResult.body = i;
+                break;
+            }
+
+        return false;
+    }
+
+    bool LDHashTrace::save(const string& mPath) const
+    {
+        ofstream o{mPath, ios::binary};
+        if(!o) return false;
+
+        const uint64_t stepCount{steps.size()};
+        o.write(reinterpret_cast<const char*>(&stepCount), sizeof(stepCount));
+        for(const auto& s : steps)
+        {
+            const uint64_t count{s.count};
+            o.write(reinterpret_cast<const char*>(&s.total), sizeof(s.total));
+            o.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            o.write(reinterpret_cast<const char*>(&s.input), sizeof(s.input));
+            o.write(reinterpret_cast<const char*>(bodies.data() + s.first),
+                s.count * sizeof(Hash));
+        }
+        return static_cast<bool>(o);
+    }
+
+    bool LDHashTrace::load(const string& mPath)
+    {
+        clear();
+        ifstream i{mPath, ios::binary};
+        if(!i) return false;
+
+        uint64_t stepCount{0};
+        i.read(reinterpret_cast<char*>(&stepCount), sizeof(stepCount));
+        for(uint64_t s{0}; i && s < stepCount; ++s)
+        {
+            Hash total;
+            uint64_t count;
+            uint8_t input;
+            i.read(reinterpret_cast<char*>(&total), sizeof(total));
+            i.read(reinterpret_cast<char*>(&count), sizeof(count));
+            i.read(reinterpret_cast<char*>(&input), sizeof(input));
+
+            steps.push_back({total, bodies.size(), count, input});
+            bodies.resize(bodies.size() + count);
+            i.read(reinterpret_cast<char*>(bodies.data() + steps.back().first),
+                count * sizeof(Hash));
+        }
+
+        if(i) return true;
+        clear();
+        return false;
+    }
+}
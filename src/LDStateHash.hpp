@@ -0,0 +1,116 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_STATEHASH
+#define SSVLD_STATEHASH
+
+#include <cstdint>
+#include <cstring>
+
+#include "LDDependencies.hpp"
+#include "LDInput.hpp"
+
+namespace ld
+{
+    // FNV-1a hash of the simulation state after a step: one hash per
+    // block/player body (position, velocity, groups, physics and gameplay
+    // fields), combined in iteration order. Floats are hashed bitwise, so
+    // any difference at all is caught. Every body is rehashed every step:
+    // bodies have no change tracking, and comparing their fields against
+    // a cache would cost as much as hashing them.
+    class LDStateHash
+    {
+    public:
+        using Hash = std::uint64_t;
+
+    private:
+        static constexpr Hash fnvOffset{14695981039346656037ull};
+        static constexpr Hash fnvPrime{1099511628211ull};
+
+        std::vector<Hash> bodies;
+        std::vector<sses::Entity*> entities;
+        Hash total{fnvOffset};
+
+    public:
+        template <typename T>
+        inline static void mix(Hash& mHash, const T& mValue) noexcept
+        {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, &mValue, sizeof(T));
+            for(auto b : bytes) mHash = (mHash ^ b) * fnvPrime;
+        }
+
+        void compute(sses::Manager& mManager);
+
+        inline Hash getTotal() const noexcept { return total; }
+        inline const std::vector<Hash>& getBodies() const noexcept
+        {
+            return bodies;
+        }
+        inline sses::Entity& getEntity(std::size_t mIdx) const noexcept
+        {
+            return *entities[mIdx];
+        }
+    };
+
+    // Reference trace of per-step hashes and the inputs that produced
+    // them. Recorded once, then replays or alternative physics paths are
+    // fed the same inputs and verified against it step by step.
+    class LDHashTrace
+    {
+    public:
+        using Hash = LDStateHash::Hash;
+
+        struct Divergence
+        {
+            std::size_t step;
+            std::size_t body; // Index in hashing order; -1 if counts differ
+        };
+
+    private:
+        struct Step
+        {
+            Hash total;
+            std::size_t first, count;
+            std::uint8_t input; // Packed `LDInput` driving the step
+        };
+
+        std::vector<Step> steps;
+        std::vector<Hash> bodies;
+        std::size_t cursor{0};
+
+    public:
+        inline void clear()
+        {
+            steps.clear();
+            bodies.clear();
+            cursor = 0;
+        }
+        inline void rewind() noexcept { cursor = 0; }
+
+        void record(const LDStateHash& mHash, const LDInput& mInput);
+
+        // Compares the next step of the trace; returns false on the first
+        // divergence (or when the trace is over), filling `mResult`
+        bool verify(const LDStateHash& mHash, Divergence& mResult);
+
+        bool save(const std::string& mPath) const;
+        bool load(const std::string& mPath);
+
+        inline std::size_t getStepCount() const noexcept
+        {
+            return steps.size();
+        }
+        inline std::size_t getCursor() const noexcept { return cursor; }
+
+        // Input for the step about to be verified; idle past the end
+        inline LDInput getInput() const noexcept
+        {
+            return cursor < steps.size() ? LDInput::unpack(steps[cursor].input)
+                                         : LDInput{};
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,97 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_STATICINDEX
+#define SSVLD_STATICINDEX
+
+#include <cstdint>
+
+#include "LDDependencies.hpp"
+#include "LDUtils.hpp"
+
+namespace ld
+{
+    // Static solids, for the sweeps the collision world cannot answer.
+    // Fixed bodies (walls) are bucketed by the cell of their center, so a
+    // query only visits the cells around its bounds. Moving solids that
+    // nothing pushes (lifts) change cells every step and are few: they stay
+    // in a plain list that every query visits.
+    class LDStaticIndex
+    {
+    public:
+        static constexpr int cellSize{3200};
+
+    private:
+        std::unordered_map<std::uint64_t, std::vector<Body*>> cells;
+        std::vector<Body*> moving;
+        int maxHalfSize{0}; // Largest half extent of any fixed body
+
+        inline static std::uint64_t getKey(const ssvs::Vec2i& mPos) noexcept
+        {
+            return getCellKey(getCellCoord(mPos.x, cellSize),
+                getCellCoord(mPos.y, cellSize));
+        }
+        inline static void erase(std::vector<Body*>& mBodies, Body& mBody)
+        {
+            for(auto& b : mBodies)
+                if(b == &mBody)
+                {
+                    b = mBodies.back();
+                    mBodies.pop_back();
+                    return;
+                }
+        }
+
+    public:
+        // Fixed bodies must not move while they are indexed
+        inline void add(Body& mBody, bool mMoving)
+        {
+            if(mMoving)
+            {
+                moving.emplace_back(&mBody);
+                return;
+            }
+
+            cells[getKey(mBody.getPosition())].emplace_back(&mBody);
+            maxHalfSize = std::max(maxHalfSize,
+                std::max(mBody.getWidth(), mBody.getHeight()) / 2);
+        }
+        inline void del(Body& mBody, bool mMoving)
+        {
+            if(mMoving)
+            {
+                erase(moving, mBody);
+                return;
+            }
+
+            auto itr(cells.find(getKey(mBody.getPosition())));
+            if(itr != std::end(cells)) erase(itr->second, mBody);
+        }
+
+        // Calls `mFn` with every body that may overlap the given bounds
+        template <typename TF>
+        inline void forEach(
+            const ssvs::Vec2i& mMin, const ssvs::Vec2i& mMax, TF mFn) const
+        {
+            for(auto b : moving) mFn(*b);
+
+            // A body is indexed by its center: grow the bounds by the
+            // largest half extent to catch bodies whose center is outside
+            const int x0{getCellCoord(mMin.x - maxHalfSize, cellSize)},
+                x1{getCellCoord(mMax.x + maxHalfSize, cellSize)},
+                y0{getCellCoord(mMin.y - maxHalfSize, cellSize)},
+                y1{getCellCoord(mMax.y + maxHalfSize, cellSize)};
+
+            for(int y{y0}; y <= y1; ++y)
+                for(int x{x0}; x <= x1; ++x)
+                {
+                    const auto itr(cells.find(getCellKey(x, y)));
+                    if(itr == std::end(cells)) continue;
+                    for(auto b : itr->second) mFn(*b);
+                }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,56 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_TIMESLICE
+#define SSVLD_TIMESLICE
+
+#include "LDDependencies.hpp"
+
+namespace ld
+{
+    // Update rates, in simulation steps per update: independent of how
+    // long a step is
+    namespace LDRate
+    {
+        constexpr unsigned int everyStep{1};
+        constexpr unsigned int halfRate{2}; // Every other step
+    }
+
+    // Lets a component update only once every `rate` steps. Time elapsed in
+    // the skipped steps is accumulated and handed to the next update.
+    // Callers give each instance a different phase (see
+    // `LDGame::getNextSlicePhase`), so components sharing a rate are spread
+    // evenly over the steps instead of all running on the same one.
+    class LDTimeSlice
+    {
+    private:
+        unsigned int rate, counter;
+        FT elapsed{0};
+
+    public:
+        inline LDTimeSlice(unsigned int mRate, unsigned int mPhase) noexcept
+            : rate{mRate}, counter{mPhase % mRate}
+        {
+        }
+
+        // Returns true if this step is the owner's turn to update
+        inline bool update(FT mFT) noexcept
+        {
+            elapsed += mFT;
+            if(++counter < rate) return false;
+            counter = 0;
+            return true;
+        }
+
+        // Returns the time accumulated since the last turn, and resets it
+        inline FT consume() noexcept
+        {
+            const auto result(elapsed);
+            elapsed = 0;
+            return result;
+        }
+    };
+}
+
+#endif
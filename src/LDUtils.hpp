@@ -5,6 +5,8 @@
 #ifndef SSVLD_UTILS
 #define SSVLD_UTILS
 
+#include <cstdint>
+
 #include "LDDependencies.hpp"
 
 namespace ld
@@ -31,6 +33,26 @@ namespace ld
     {
         return {toCoords(mValue.x), toCoords(mValue.y)};
     }
+
+    // Cell index of `mValue` in a grid of `mCellSize` cells, rounded down
+    inline int getCellCoord(int mValue, int mCellSize) noexcept
+    {
+        return mValue >= 0 ? mValue / mCellSize
+                           : (mValue - mCellSize + 1) / mCellSize;
+    }
+    // Packs signed cell coordinates into one hash key; the casts keep
+    // negative coordinates well-defined
+    inline std::uint64_t getCellKey(int mX, int mY) noexcept
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(mX))
+                   << 32) |
+               static_cast<std::uint32_t>(mY);
+    }
+    inline ssvs::Vec2i getCellCoords(std::uint64_t mKey) noexcept
+    {
+        return {static_cast<int>(static_cast<std::uint32_t>(mKey >> 32)),
+            static_cast<int>(static_cast<std::uint32_t>(mKey))};
+    }
 }
 
 #endif
@@ -0,0 +1,50 @@
+// Copyright (c) 2013-2015 Vittorio Romeo
+// License: Academic Free License ("AFL") v. 3.0
+// AFL License page: http://opensource.org/licenses/AFL-3.0
+
+#ifndef SSVLD_WAKESIGNAL
+#define SSVLD_WAKESIGNAL
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace ld
+{
+    // Lets a worker thread sleep until a producer has work for it, next to
+    // a lock-free queue or buffer. `notify` only takes the mutex when the
+    // worker is actually asleep, so a busy producer never locks anything.
+    class LDWakeSignal
+    {
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<bool> sleeping{false};
+
+    public:
+        // Producer: call after publishing the work
+        inline void notify()
+        {
+            // Pairs with the fence in `wait`: either the worker sees the
+            // work, or this sees the worker asleep
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(!sleeping.load(std::memory_order_relaxed)) return;
+
+            std::lock_guard<std::mutex> lock{mutex};
+            cv.notify_one();
+        }
+
+        // Worker: blocks until `mReady` returns true
+        template <typename TF>
+        inline void wait(TF mReady)
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cv.wait(lock, mReady);
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+    };
+}
+
+#endif
@@ -2,6 +2,8 @@
 // License: Academic Free License ("AFL") v. 3.0
 // AFL License page: http://opensource.org/licenses/AFL-3.0
 
+#include <cstdlib>
+
 #include "LDDependencies.hpp"
 #include "LDAssets.hpp"
 #include "LDConfig.hpp"
@@ -18,6 +20,33 @@ using namespace ssvms;
 
 int main()
 {
+    // Headless checks, run by ctest: no window is opened, and there is no
+    // menu, audio or texture upload.
+    // LD27_RENDER_BENCH=<frames> draws every level into a null sink and
+    // exits with a failure if a frame goes over the render budget;
+    // LD27_LOOPBACK_TEST=<steps> plays co-op against a second local game
+    // and exits with a failure on a desync or a wrong spectator view;
+    // LD27_CHECK_LEVELS=1 runs the solver heuristic over every level and
+    // exits with a failure if one is found broken
+    const auto bench(std::getenv("LD27_RENDER_BENCH"));
+    const auto steps(std::getenv("LD27_LOOPBACK_TEST"));
+    const auto check(std::getenv("LD27_CHECK_LEVELS"));
+    if(bench != nullptr || steps != nullptr || check != nullptr)
+    {
+        LDAssets assets{true};
+        GameWindow gameWindow; // Never opened: it is never sized or run
+        LDGame game{gameWindow, assets};
+        game.setRenderSink(mkUPtr<LDNullSink>());
+
+        if(bench != nullptr)
+            return game.benchmarkRender(std::atoi(bench)) ? 0 : 1;
+        if(check != nullptr) return game.checkLevels() ? 0 : 1;
+
+        LDGame guest{gameWindow, assets};
+        guest.setRenderSink(mkUPtr<LDNullSink>());
+        return game.testLoopback(guest, std::atoi(steps)) ? 0 : 1;
+    }
+
     unsigned int width{VideoMode::getDesktopMode().width},
         height{VideoMode::getDesktopMode().height};
     width = 800;
@@ -30,13 +59,22 @@ int main()
     gameWindow.setTimer<TimerStatic>(0.5f, 0.5f);
     gameWindow.setSize(width, height);
     gameWindow.setFullscreen(false);
-    gameWindow.setFPSLimited(true);
-    gameWindow.setMaxFPS(200);
+    gameWindow.setFPSLimited(false); // LDFramePacer paces every frame
 
     LDGame game{gameWindow, assets};
     LDMenu menuGame{gameWindow, assets, game};
 
     game.setMenuGame(menuGame);
+
+    // LD27_RENDER=null|texture picks another render sink
+    if(const auto sink = std::getenv("LD27_RENDER"))
+    {
+        if(std::string{sink} == "null")
+            game.setRenderSink(mkUPtr<LDNullSink>());
+        else if(std::string{sink} == "texture")
+            game.setRenderSink(mkUPtr<LDTextureSink>(gameWindow));
+    }
+
     gameWindow.setGameState(menuGame.gameState);
     gameWindow.run();
 